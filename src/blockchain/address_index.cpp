@@ -0,0 +1,144 @@
+#include "address_index.h"
+
+/**
+ * The address index constructor
+ */
+AddressIndex::AddressIndex () {}
+
+/**
+ * Gets the address of a public key
+ *
+ * @param key - The public key's PEM
+ * @returns The key's address
+ */
+Hash256 AddressIndex::address ( const std::string &key ) {
+	return KeyTable::key_id ( key );
+}
+
+/**
+ * Indexes every output and input in a stored block
+ * (The coinbase's input doesn't spend anything, so it isn't debited)
+ *
+ * @param height - The block's position in the chain
+ * @param block - A view of the stored block
+ */
+void AddressIndex::add_block ( size_t height, BlockView block ) {
+	for ( TransactionIterator entry = block.begin (); entry != block.end (); ++entry ) {
+		TransactionView transaction = *entry;
+		size_t position = entry.position ();
+
+		// Debits the spent outputs
+		if ( position != 0 )
+			for ( size_t x = 0; x < transaction.input_count (); x++ ) {
+				TransactionOutputView spent = transaction.input ( x ).prev_out ();
+				this -> entries[spent.recipient ()].balance -= spent.value ();
+			}
+
+		// Credits the recipients and records the output for both sides
+		for ( size_t x = 0; x < transaction.output_count (); x++ ) {
+			TransactionOutputView output = transaction.output ( x );
+			OutputRef ref { (uint32_t) height, (uint32_t) position, (uint32_t) x };
+
+			Hash256 recipient = output.recipient ();
+			Entry &entry = this -> entries[recipient];
+			entry.balance += output.value ();
+			entry.outputs.push_back ( ref );
+
+			if ( !( output.author ().is_zero () ) && output.author () != output.recipient () )
+				this -> entries[output.author ()].outputs.push_back ( ref );
+		}
+	}
+}
+
+/**
+ * Reverts add_block for the most recently indexed block
+ *
+ * @param height - The block's position in the chain
+ * @param block - A view of the stored block
+ */
+void AddressIndex::remove_block ( size_t height, BlockView block ) {
+	std::vector<TransactionView> transactions ( block.begin (), block.end () );
+	for ( size_t position = transactions.size (); position-- > 0; ) {
+		TransactionView &transaction = transactions[position];
+
+		// Removes the outputs, newest first
+		for ( size_t x = transaction.output_count (); x-- > 0; ) {
+			TransactionOutputView output = transaction.output ( x );
+
+			if ( !( output.author ().is_zero () ) && output.author () != output.recipient () )
+				this -> pop_output ( output.author (), height, 0 );
+
+			this -> pop_output ( output.recipient (), height, output.value () );
+		}
+
+		// Refunds the spent outputs
+		if ( position != 0 )
+			for ( size_t x = 0; x < transaction.input_count (); x++ ) {
+				TransactionOutputView spent = transaction.input ( x ).prev_out ();
+				this -> entries[spent.recipient ()].balance += spent.value ();
+			}
+	}
+}
+
+/**
+ * Removes an address's newest output reference
+ *
+ * @param address - The address
+ * @param height - The height the reference must belong to
+ * @param value - The value which should be debited from the address
+ */
+void AddressIndex::pop_output ( const Hash256 &address, size_t height, long value ) {
+	Entry &entry = this -> entries[address];
+	if ( entry.outputs.empty () || entry.outputs.back ().height != height )
+		throw std::runtime_error ( "Attempted removing a block out of order!" );
+
+	entry.outputs.pop_back ();
+	entry.balance -= value;
+
+	if ( entry.outputs.empty () && entry.balance == 0 )
+		this -> entries.erase ( address );
+}
+
+void AddressIndex::clear () {
+	this -> entries.clear ();
+}
+
+/**
+ * Gets an address's confirmed balance
+ *
+ * @param address - The address
+ * @returns The balance
+ */
+long AddressIndex::balance ( const Hash256 &address ) const {
+	auto entry = this -> entries.find ( address );
+	return entry == this -> entries.end () ? 0 : entry -> second.balance;
+}
+
+/**
+ * Gets the number of outputs an address appears in
+ *
+ * @param address - The address
+ * @returns The length of the address's history
+ */
+size_t AddressIndex::history_size ( const Hash256 &address ) const {
+	auto entry = this -> entries.find ( address );
+	return entry == this -> entries.end () ? 0 : entry -> second.outputs.size ();
+}
+
+/**
+ * Gets a page of the outputs an address appears in, oldest first
+ *
+ * @param address - The address
+ * @param offset - The number of outputs to skip
+ * @param count - The maximum number of outputs to return
+ * @returns The outputs' references
+ */
+std::vector<OutputRef> AddressIndex::history ( const Hash256 &address, size_t offset, size_t count ) const {
+	auto entry = this -> entries.find ( address );
+	if ( entry == this -> entries.end () || offset >= entry -> second.outputs.size () )
+		return std::vector<OutputRef> ();
+
+	auto begin = entry -> second.outputs.begin () + offset;
+	auto end = begin + std::min ( count, entry -> second.outputs.size () - offset );
+	return std::vector<OutputRef> ( begin, end );
+}
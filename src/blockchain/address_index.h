@@ -0,0 +1,53 @@
+#pragma once
+#ifndef ADDRESS_INDEX_H
+#define ADDRESS_INDEX_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <unordered_map>
+#include "views.h"
+#include "key_table.h"
+#include "algorithms/crypto.h"
+#include "algorithms/hash256.h"
+
+/**
+ * A reference to one output of a mined transaction
+ */
+struct OutputRef {
+	uint32_t height;
+	uint32_t position;
+	uint32_t output;
+};
+
+/**
+ * Tracks every address's balance and the outputs it appears in
+ * (An address is a public key's ID, the SHA256 of its PEM; the balance is what the
+ * address has recieved minus what it has spent through transaction inputs)
+ */
+class AddressIndex {
+	public:
+		AddressIndex ();
+
+		static Hash256 address ( const std::string &key );
+
+		void add_block ( size_t height, BlockView block );
+		void remove_block ( size_t height, BlockView block );
+		void clear ();
+
+		long balance ( const Hash256 &address ) const;
+		size_t history_size ( const Hash256 &address ) const;
+		std::vector<OutputRef> history ( const Hash256 &address, size_t offset, size_t count ) const;
+
+	private:
+		struct Entry {
+			long balance;
+			std::vector<OutputRef> outputs;
+		};
+
+		std::unordered_map<Hash256, Entry> entries;
+
+		void pop_output ( const Hash256 &address, size_t height, long value );
+};
+
+#endif
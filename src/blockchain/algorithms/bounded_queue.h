@@ -0,0 +1,99 @@
+#pragma once
+#ifndef BOUNDED_QUEUE_H
+#define BOUNDED_QUEUE_H
+
+#include <deque>
+#include <mutex>
+#include <utility>
+#include <condition_variable>
+
+/**
+ * A thread-safe FIFO queue with a fixed capacity
+ * (Producers block while the queue is full, which is how a slow consumer
+ * pushes back on them; once closed, consumers drain what's left)
+ */
+template <typename Value>
+class BoundedQueue {
+	public:
+		BoundedQueue ( size_t capacity );
+
+		bool push ( Value value );
+		bool pop ( Value &value );
+		void close ();
+		size_t size ();
+
+	private:
+		size_t capacity;
+		bool closed;
+		std::mutex mutex;
+		std::condition_variable not_full;
+		std::condition_variable not_empty;
+		std::deque<Value> values;
+};
+
+/**
+ * The queue constructor
+ *
+ * @param capacity - The most values the queue holds at once (at least one)
+ */
+template <typename Value>
+BoundedQueue<Value>::BoundedQueue ( size_t capacity ) {
+	this -> capacity = capacity == 0 ? 1 : capacity;
+	this -> closed = false;
+}
+
+/**
+ * Appends a value, waiting for space if the queue is full
+ *
+ * @param value - The value
+ * @returns Whether or not the value was queued (false once the queue is closed)
+ */
+template <typename Value>
+bool BoundedQueue<Value>::push ( Value value ) {
+	std::unique_lock<std::mutex> lock ( this -> mutex );
+	this -> not_full.wait ( lock, [this] () { return this -> closed || this -> values.size () < this -> capacity; } );
+	if ( this -> closed )
+		return false;
+
+	this -> values.push_back ( std::move ( value ) );
+	this -> not_empty.notify_one ();
+	return true;
+}
+
+/**
+ * Removes the oldest value, waiting for one if the queue is empty
+ *
+ * @param value - Recieves the value
+ * @returns Whether or not a value was removed (false once the queue is closed and empty)
+ */
+template <typename Value>
+bool BoundedQueue<Value>::pop ( Value &value ) {
+	std::unique_lock<std::mutex> lock ( this -> mutex );
+	this -> not_empty.wait ( lock, [this] () { return this -> closed || !( this -> values.empty () ); } );
+	if ( this -> values.empty () )
+		return false;
+
+	value = std::move ( this -> values.front () );
+	this -> values.pop_front ();
+	this -> not_full.notify_one ();
+	return true;
+}
+
+/**
+ * Stops accepting values and wakes every waiting thread
+ */
+template <typename Value>
+void BoundedQueue<Value>::close () {
+	std::lock_guard<std::mutex> lock ( this -> mutex );
+	this -> closed = true;
+	this -> not_full.notify_all ();
+	this -> not_empty.notify_all ();
+}
+
+template <typename Value>
+size_t BoundedQueue<Value>::size () {
+	std::lock_guard<std::mutex> lock ( this -> mutex );
+	return this -> values.size ();
+}
+
+#endif
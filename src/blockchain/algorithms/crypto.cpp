@@ -8,22 +8,41 @@ namespace crypto {
 	* @param input - The string which should be encoded
 	* @returns A hex encoded string representing the input
 	*/
-	std::string to_hex ( std::string input ) {
-		std::stringstream stream;
-		for ( auto c : input ) {
-			stream << std::setfill ( '0' ) << std::setw ( 2 ) << std::uppercase << std::hex << ( 0xFF & c );
+	std::string to_hex ( const std::string &input ) {
+		static const char digits[] = "0123456789ABCDEF";
+
+		std::string output ( 2 * input.length (), '0' );
+		for ( size_t x = 0; x < input.length (); x++ ) {
+			output[2 * x] = digits[( 0xFF & input[x] ) >> 4];
+			output[2 * x + 1] = digits[0x0F & input[x]];
 		}
-		return stream.str ();
+		return output;
 	}
 
 
+	/**
+	* Gets the value of a single hex digit
+	*
+	* @param digit - The hex digit
+	* @returns The digit's value, or -1 if it isn't a hex digit
+	*/
+	static int from_hex_digit ( char digit ) {
+		if ( digit >= '0' && digit <= '9' )
+			return digit - '0';
+		if ( digit >= 'a' && digit <= 'f' )
+			return digit - 'a' + 10;
+		if ( digit >= 'A' && digit <= 'F' )
+			return digit - 'A' + 10;
+		return -1;
+	}
+
 	/**
 	* Converts a given hex string into an ascii string
 	*
 	* @param input - The string which should be decoded
 	* @returns The ascii representation of the hex encoded string
 	*/
-	std::string from_hex ( std::string input ) {
+	std::string from_hex ( const std::string &input ) {
 		std::string output;
 
 		// Calculates the output length
@@ -31,15 +50,15 @@ namespace crypto {
 			throw std::runtime_error ( "Invalid hex string conversion!" );
 
 		size_t output_length = input.length () / 2;
+		output.resize ( output_length );
 
 		for ( size_t x = 0; x < output_length; x++ ) {
-			uint32_t s = 0;
-			std::stringstream stream;
-
-			stream << std::hex << input.substr ( x * 2, 2 );
-			stream >> s;
+			int high = from_hex_digit ( input[x * 2] );
+			int low = from_hex_digit ( input[x * 2 + 1] );
+			if ( high < 0 || low < 0 )
+				throw std::runtime_error ( "Invalid hex string conversion!" );
 
-			output.push_back ( static_cast<unsigned char> ( s ) );
+			output[x] = static_cast<char> ( ( high << 4 ) | low );
 		}
 
 		return output;
@@ -51,44 +70,74 @@ namespace crypto {
 	* @param input - The string which should be hashed
 	* @returns The hash of the given input
 	*/
-	std::string sha256 ( std::string input ) {
-		unsigned char raw_hash[SHA256_DIGEST_LENGTH];
-		SHA256_CTX sha256;
-		SHA256_Init ( &sha256 );
-		SHA256_Update ( &sha256, input.c_str (), input.length () );
-		SHA256_Final ( raw_hash, &sha256 );
-
-		std::string hex_hash ( reinterpret_cast<char*> ( raw_hash ), SHA256_DIGEST_LENGTH );
-		return to_hex ( hex_hash );
+	Hash256 sha256 ( const std::string &input ) {
+		return sha256 ( reinterpret_cast<const unsigned char*> ( input.data () ), input.length () );
+	}
+
+	/**
+	* Hashes a given buffer with the sha256 algorithm
+	*
+	* @param input - The buffer which should be hashed
+	* @param length - The length of the buffer
+	* @returns The hash of the given input
+	*/
+	Hash256 sha256 ( const unsigned char *input, size_t length ) {
+		Hash256 hash;
+		sha256_digest ( input, length, hash.bytes );
+		return hash;
+	}
+
+	/**
+	* Hashes several independent strings in one batch
+	*
+	* @param inputs - The strings which should be hashed
+	* @returns The hash of each input, in order
+	*/
+	std::vector<Hash256> sha256_many ( const std::vector<std::string> &inputs ) {
+		std::vector<const unsigned char*> data;
+		std::vector<size_t> lengths;
+		for ( auto &input : inputs ) {
+			data.push_back ( reinterpret_cast<const unsigned char*> ( input.data () ) );
+			lengths.push_back ( input.length () );
+		}
+
+		std::vector<Hash256> hashes ( inputs.size () );
+		if ( inputs.empty () )
+			return hashes;
+
+		sha256_many ( data.data (), lengths.data (), inputs.size (), hashes.data () -> bytes );
+		return hashes;
 	}
 
 	/**
 	* Calculates the merkel tree of a given vector
+	* (Nodes are paired from the left, each parent being the hash of its two
+	* children's digests, and a trailing unpaired node is hashed on its own)
 	*
-	* @param nodes - The vector containing the nodes of the tree
-	* @returns The merkel tree
+	* @param nodes - The vector containing the leaves of the tree
+	* @returns The merkel tree's root (zero for an empty tree)
 	*/
-	std::string merkel_tree ( std::vector<std::string> tree ) {
+	Hash256 merkel_tree ( std::vector<Hash256> nodes ) {
 
-		std::vector<std::string> nodes = tree;
+		if ( nodes.empty () )
+			return Hash256 {};
 
 		// Continues to hash the tree
 		while ( nodes.size () > 1 ) {
 
-			std::vector<std::string> tmp_nodes;
-			std::string tmp_hash;
-			for ( std::vector<std::string>::iterator node = nodes.begin (); node < nodes.end (); node++ ) {
-
-				if ( !( ( nodes.end () - node ) % 2 ) ) 
-					tmp_hash.append ( sha256 ( *node ) );
-				else {
-					tmp_hash.append ( sha256 ( *node ) );
-					tmp_nodes.push_back ( tmp_hash );
-					tmp_hash = "";
-				}
+			// Each pair is contiguous in the vector, so it's hashed in place
+			size_t parents = ( nodes.size () + 1 ) / 2;
+			std::vector<const unsigned char*> inputs ( parents );
+			std::vector<size_t> lengths ( parents );
+			for ( size_t x = 0; x < parents; x++ ) {
+				inputs[x] = nodes[2 * x].bytes;
+				lengths[x] = std::min ( nodes.size () - 2 * x, (size_t) 2 ) * sizeof ( Hash256 );
 			}
 
-			nodes = tmp_nodes;
+			// Hashes the whole level in one batch
+			std::vector<Hash256> tmp_nodes ( parents );
+			sha256_many ( inputs.data (), lengths.data (), parents, tmp_nodes.data () -> bytes );
+			nodes.swap ( tmp_nodes );
 		}
 
 		return nodes.front ();
@@ -7,15 +7,20 @@
 #include <iostream>
 #include <sstream>
 #include <iomanip>
+#include <algorithm>
 #include <openssl/sha.h>
+#include "sha256.h"
+#include "hash256.h"
 
 namespace crypto {
-	std::string to_hex ( std::string input );
-	std::string from_hex ( std::string input );
+	std::string to_hex ( const std::string &input );
+	std::string from_hex ( const std::string &input );
 
-	std::string sha256 ( std::string input );
+	Hash256 sha256 ( const std::string &input );
+	Hash256 sha256 ( const unsigned char *input, size_t length );
+	std::vector<Hash256> sha256_many ( const std::vector<std::string> &inputs );
 
-	std::string merkel_tree ( std::vector<std::string> nodes );
+	Hash256 merkel_tree ( std::vector<Hash256> nodes );
 }
 
 #endif
\ No newline at end of file
@@ -0,0 +1,25 @@
+#include "hash256.h"
+#include "crypto.h"
+
+/**
+ * Checks if every byte of the hash is zero
+ * (The genesis block's previous hash is all zeros)
+ *
+ * @returns Whether or not the hash is zero
+ */
+bool Hash256::is_zero () const {
+	for ( auto byte : this -> bytes )
+		if ( byte != 0 )
+			return false;
+
+	return true;
+}
+
+/**
+ * Converts the hash to an uppercase hex string for display
+ *
+ * @returns The hex encoded hash
+ */
+std::string Hash256::to_hex () const {
+	return crypto::to_hex ( std::string ( reinterpret_cast<const char*> ( this -> bytes ), sizeof ( this -> bytes ) ) );
+}
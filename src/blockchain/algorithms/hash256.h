@@ -0,0 +1,41 @@
+#pragma once
+#ifndef HASH256_H
+#define HASH256_H
+
+#include <string>
+#include <cstring>
+#include <cstddef>
+#include <functional>
+#include <type_traits>
+#include <openssl/sha.h>
+
+struct Hash256 {
+	unsigned char bytes[SHA256_DIGEST_LENGTH];
+
+	bool is_zero () const;
+	std::string to_hex () const;
+
+	bool operator== ( const Hash256 &other ) const { return std::memcmp ( this -> bytes, other.bytes, sizeof ( this -> bytes ) ) == 0; }
+	bool operator!= ( const Hash256 &other ) const { return !( *this == other ); }
+	bool operator< ( const Hash256 &other ) const { return std::memcmp ( this -> bytes, other.bytes, sizeof ( this -> bytes ) ) < 0; }
+};
+
+static_assert ( std::is_trivially_copyable<Hash256>::value, "Hash256 must stay trivially copyable" );
+static_assert ( sizeof ( Hash256 ) == SHA256_DIGEST_LENGTH, "Hash256 must stay exactly one digest wide" );
+
+namespace std {
+
+	/**
+	 * Hashes a Hash256 for unordered containers
+	 * (The digest is already uniformly distributed, so its first bytes are used as is)
+	 */
+	template <> struct hash<Hash256> {
+		size_t operator() ( const Hash256 &hash ) const noexcept {
+			size_t value;
+			std::memcpy ( &value, hash.bytes, sizeof ( value ) );
+			return value;
+		}
+	};
+}
+
+#endif
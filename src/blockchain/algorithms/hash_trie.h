@@ -0,0 +1,203 @@
+#pragma once
+#ifndef HASH_TRIE_H
+#define HASH_TRIE_H
+
+#include <memory>
+#include <utility>
+#include "hash256.h"
+
+/**
+ * An immutable map from hashes to values, which is updated by path copying
+ * (A 16-way radix trie over the key's nibbles; since keys are digests the trie
+ * stays balanced, so an update copies about log16(n) nodes and shares the
+ * rest with the previous version, which stays valid for its readers)
+ */
+template <typename Value>
+class HashTrie {
+	public:
+		HashTrie ();
+
+		bool find ( const Hash256 &key, Value &value ) const;
+		HashTrie set ( const Hash256 &key, Value value ) const;
+		HashTrie erase ( const Hash256 &key ) const;
+		size_t size () const;
+
+	private:
+		struct Node;
+		typedef std::shared_ptr<const Node> NodePointer;
+
+		struct Node {
+			bool is_leaf;
+			Hash256 key;
+			Value value;
+			NodePointer children[16];
+		};
+
+		NodePointer root;
+		size_t count;
+
+		HashTrie ( NodePointer root, size_t count );
+
+		static int nibble ( const Hash256 &key, int depth );
+		static NodePointer insert ( const NodePointer &node, const Hash256 &key, const Value &value, int depth, bool &added );
+		static NodePointer remove ( const NodePointer &node, const Hash256 &key, int depth, bool &removed );
+};
+
+/**
+ * The trie constructor (creates an empty trie)
+ */
+template <typename Value>
+HashTrie<Value>::HashTrie (): HashTrie ( nullptr, 0 ) {}
+
+template <typename Value>
+HashTrie<Value>::HashTrie ( NodePointer root, size_t count ) {
+	this -> root = std::move ( root );
+	this -> count = count;
+}
+
+/**
+ * Looks up a key
+ *
+ * @param key - The key
+ * @param value - Recieves the key's value
+ * @returns Whether or not the key was found
+ */
+template <typename Value>
+bool HashTrie<Value>::find ( const Hash256 &key, Value &value ) const {
+	const Node *node = this -> root.get ();
+	for ( int depth = 0; node != nullptr; depth++ ) {
+		if ( node -> is_leaf ) {
+			if ( node -> key != key )
+				return false;
+
+			value = node -> value;
+			return true;
+		}
+
+		node = node -> children[nibble ( key, depth )].get ();
+	}
+
+	return false;
+}
+
+/**
+ * Creates a version of the trie with a key set to a value
+ *
+ * @param key - The key
+ * @param value - The key's new value
+ * @returns The new version
+ */
+template <typename Value>
+HashTrie<Value> HashTrie<Value>::set ( const Hash256 &key, Value value ) const {
+	bool added = false;
+	NodePointer root = insert ( this -> root, key, value, 0, added );
+	return HashTrie ( std::move ( root ), this -> count + ( added ? 1 : 0 ) );
+}
+
+/**
+ * Creates a version of the trie without a key
+ *
+ * @param key - The key
+ * @returns The new version
+ */
+template <typename Value>
+HashTrie<Value> HashTrie<Value>::erase ( const Hash256 &key ) const {
+	bool removed = false;
+	NodePointer root = remove ( this -> root, key, 0, removed );
+	if ( !removed )
+		return *this;
+
+	return HashTrie ( std::move ( root ), this -> count - 1 );
+}
+
+template <typename Value>
+size_t HashTrie<Value>::size () const {
+	return this -> count;
+}
+
+/**
+ * Gets the nibble of a key which picks the child at a given depth
+ *
+ * @param key - The key
+ * @param depth - The depth, at most 63
+ * @returns The nibble
+ */
+template <typename Value>
+int HashTrie<Value>::nibble ( const Hash256 &key, int depth ) {
+	unsigned char byte = key.bytes[depth / 2];
+	return depth % 2 == 0 ? byte >> 4 : byte & 0x0F;
+}
+
+/**
+ * Copies the path to a key, setting its value
+ *
+ * @param node - The subtrie
+ * @param key - The key
+ * @param value - The key's value
+ * @param depth - The subtrie's depth
+ * @param added - Set if the key wasn't in the subtrie
+ * @returns The new subtrie
+ */
+template <typename Value>
+typename HashTrie<Value>::NodePointer HashTrie<Value>::insert ( const NodePointer &node, const Hash256 &key, const Value &value, int depth, bool &added ) {
+	if ( node == nullptr || ( node -> is_leaf && node -> key == key ) ) {
+		added = node == nullptr;
+
+		auto leaf = std::make_shared<Node> ();
+		leaf -> is_leaf = true;
+		leaf -> key = key;
+		leaf -> value = value;
+		return leaf;
+	}
+
+	auto branch = std::make_shared<Node> ();
+	branch -> is_leaf = false;
+
+	// Splits a leaf for a different key into a branch holding it
+	if ( node -> is_leaf )
+		branch -> children[nibble ( node -> key, depth )] = node;
+	else
+		for ( int x = 0; x < 16; x++ )
+			branch -> children[x] = node -> children[x];
+
+	int child = nibble ( key, depth );
+	branch -> children[child] = insert ( branch -> children[child], key, value, depth + 1, added );
+	return branch;
+}
+
+/**
+ * Copies the path to a key, removing it
+ * (Branches left empty are dropped)
+ *
+ * @param node - The subtrie
+ * @param key - The key
+ * @param depth - The subtrie's depth
+ * @param removed - Set if the key was in the subtrie
+ * @returns The new subtrie
+ */
+template <typename Value>
+typename HashTrie<Value>::NodePointer HashTrie<Value>::remove ( const NodePointer &node, const Hash256 &key, int depth, bool &removed ) {
+	if ( node == nullptr )
+		return node;
+
+	if ( node -> is_leaf ) {
+		removed = node -> key == key;
+		return removed ? nullptr : node;
+	}
+
+	int child = nibble ( key, depth );
+	NodePointer replaced = remove ( node -> children[child], key, depth + 1, removed );
+	if ( !removed )
+		return node;
+
+	auto branch = std::make_shared<Node> ( *node );
+	branch -> children[child] = std::move ( replaced );
+
+	for ( int x = 0; x < 16; x++ )
+		if ( branch -> children[x] != nullptr )
+			return branch;
+
+	return nullptr;
+}
+
+#endif
@@ -0,0 +1,114 @@
+#pragma once
+#ifndef LRU_CACHE_H
+#define LRU_CACHE_H
+
+#include <list>
+#include <mutex>
+#include <utility>
+#include <unordered_map>
+
+/**
+ * A bounded, thread-safe map which evicts its least recently used entry when full
+ */
+template <typename Key, typename Value>
+class LruCache {
+	public:
+		LruCache ( size_t capacity );
+
+		bool get ( const Key &key, Value &value );
+		bool contains ( const Key &key );
+		void put ( const Key &key, Value value );
+		size_t size ();
+
+	private:
+		typedef std::list<std::pair<Key, Value>> Entries;
+
+		size_t capacity;
+		std::mutex mutex;
+		Entries entries;
+		std::unordered_map<Key, typename Entries::iterator> index;
+};
+
+/**
+ * The cache constructor
+ *
+ * @param capacity - The maximum number of entries
+ */
+template <typename Key, typename Value>
+LruCache<Key, Value>::LruCache ( size_t capacity ) {
+	this -> capacity = capacity;
+}
+
+/**
+ * Looks up an entry, marking it as recently used
+ *
+ * @param key - The entry's key
+ * @param value - Recieves the entry's value
+ * @returns Whether or not the entry was found
+ */
+template <typename Key, typename Value>
+bool LruCache<Key, Value>::get ( const Key &key, Value &value ) {
+	std::lock_guard<std::mutex> lock ( this -> mutex );
+
+	auto entry = this -> index.find ( key );
+	if ( entry == this -> index.end () )
+		return false;
+
+	this -> entries.splice ( this -> entries.begin (), this -> entries, entry -> second );
+	value = entry -> second -> second;
+	return true;
+}
+
+/**
+ * Checks for an entry, marking it as recently used
+ *
+ * @param key - The entry's key
+ * @returns Whether or not the entry was found
+ */
+template <typename Key, typename Value>
+bool LruCache<Key, Value>::contains ( const Key &key ) {
+	Value value;
+	return this -> get ( key, value );
+}
+
+/**
+ * Inserts or replaces an entry, evicting the least recently used entry if the cache is full
+ *
+ * @param key - The entry's key
+ * @param value - The entry's value
+ */
+template <typename Key, typename Value>
+void LruCache<Key, Value>::put ( const Key &key, Value value ) {
+	std::lock_guard<std::mutex> lock ( this -> mutex );
+
+	auto entry = this -> index.find ( key );
+	if ( entry != this -> index.end () ) {
+		entry -> second -> second = value;
+		this -> entries.splice ( this -> entries.begin (), this -> entries, entry -> second );
+		return;
+	}
+
+	if ( this -> capacity == 0 )
+		return;
+
+	if ( this -> entries.size () >= this -> capacity ) {
+		this -> index.erase ( this -> entries.back ().first );
+		this -> entries.pop_back ();
+	}
+
+	this -> entries.emplace_front ( key, value );
+	this -> index[key] = this -> entries.begin ();
+}
+
+/**
+ * Gets the number of entries
+ *
+ * @returns The number of cached entries
+ */
+template <typename Key, typename Value>
+size_t LruCache<Key, Value>::size () {
+	std::lock_guard<std::mutex> lock ( this -> mutex );
+	return this -> entries.size ();
+}
+
+#endif
@@ -0,0 +1,206 @@
+#include "merkle_tree.h"
+
+/**
+ * The merkle tree constructor
+ * (Keeps every level of the tree so that a single leaf can be updated with
+ * one hash per level, instead of rebuilding the tree)
+ */
+MerkleTree::MerkleTree () {}
+
+/**
+ * Gets the number of leaves
+ *
+ * @returns The number of leaves in the tree
+ */
+size_t MerkleTree::size () {
+	return this -> levels.empty () ? 0 : this -> levels.front ().size ();
+}
+
+/**
+ * Appends a leaf to the tree
+ *
+ * @param leaf - The new leaf
+ */
+void MerkleTree::append ( Hash256 leaf ) {
+	if ( this -> levels.empty () )
+		this -> levels.emplace_back ();
+
+	this -> levels.front ().push_back ( leaf );
+	this -> update ( this -> levels.front ().size () - 1 );
+}
+
+/**
+ * Appends several leaves to the tree
+ * (The new nodes are hashed level by level once every leaf is in, which
+ * takes about two hashes per leaf instead of one per level for each)
+ *
+ * @param leaves - The new leaves
+ */
+void MerkleTree::append ( const std::vector<Hash256> &leaves ) {
+	if ( leaves.empty () )
+		return;
+
+	if ( this -> levels.empty () )
+		this -> levels.emplace_back ();
+
+	size_t first = this -> levels.front ().size ();
+	this -> levels.front ().insert ( this -> levels.front ().end (), leaves.begin (), leaves.end () );
+	this -> update_from ( first );
+}
+
+/**
+ * Replaces an existing leaf
+ *
+ * @param position - The position of the leaf
+ * @param leaf - The new leaf
+ */
+void MerkleTree::replace ( size_t position, Hash256 leaf ) {
+	if ( position >= this -> size () )
+		throw std::runtime_error ( "Attempted replacing a leaf outside the merkle tree!" );
+
+	this -> levels.front ()[position] = leaf;
+	this -> update ( position );
+}
+
+/**
+ * Removes every leaf
+ */
+void MerkleTree::clear () {
+	this -> levels.clear ();
+}
+
+/**
+ * Gets the root of the tree (zero for an empty tree)
+ *
+ * @returns The merkle root
+ */
+Hash256 MerkleTree::root () {
+	if ( this -> levels.empty () )
+		return Hash256 {};
+
+	return this -> levels.back ().front ();
+}
+
+/**
+ * Builds an inclusion proof for a leaf
+ * (Only the siblings are stored, a trailing unpaired node is implied by the leaf count)
+ *
+ * @param position - The position of the leaf
+ * @returns The sibling of each node on the leaf's path to the root
+ */
+MerkleProof MerkleTree::proof ( size_t position ) {
+	if ( position >= this -> size () )
+		throw std::runtime_error ( "Attempted proving a leaf outside the merkle tree!" );
+
+	MerkleProof proof { position, this -> size (), {} };
+	for ( size_t level = 0; this -> levels[level].size () > 1; level++ ) {
+		std::vector<Hash256> &nodes = this -> levels[level];
+
+		if ( position % 2 )
+			proof.siblings.push_back ( nodes[position - 1] );
+		else if ( position + 1 < nodes.size () )
+			proof.siblings.push_back ( nodes[position + 1] );
+
+		position /= 2;
+	}
+
+	return proof;
+}
+
+/**
+ * Verifies an inclusion proof against a merkle root
+ * (Doesn't need the tree, only the leaf and the block header's root)
+ *
+ * @param leaf - The hash of the transaction which should be included
+ * @param proof - The proof returned by MerkleTree::proof
+ * @param root - The merkle root from the block header
+ * @returns Whether or not the leaf is in the tree
+ */
+bool MerkleTree::verify_proof ( Hash256 leaf, MerkleProof proof, Hash256 root ) {
+	if ( proof.position >= proof.leaves )
+		return false;
+
+	Hash256 node = leaf;
+	Hash256 pair[2];
+	size_t position = proof.position;
+	size_t sibling = 0;
+
+	for ( size_t nodes = proof.leaves; nodes > 1; nodes = ( nodes + 1 ) / 2 ) {
+
+		// Hashes the node with its sibling, or alone if it's the trailing unpaired node
+		if ( position % 2 || position + 1 < nodes ) {
+			if ( sibling == proof.siblings.size () )
+				return false;
+
+			pair[position % 2 ? 0 : 1] = proof.siblings[sibling++];
+			pair[position % 2 ? 1 : 0] = node;
+			node = crypto::sha256 ( pair[0].bytes, sizeof ( pair ) );
+		} else
+			node = crypto::sha256 ( node.bytes, sizeof ( node ) );
+
+		position /= 2;
+	}
+
+	return sibling == proof.siblings.size () && node == root;
+}
+
+/**
+ * Recalculates every node on the path from a leaf to the root
+ * (Follows the same pairing as crypto::merkel_tree)
+ *
+ * @param position - The position of the leaf which changed
+ */
+void MerkleTree::update ( size_t position ) {
+	for ( size_t level = 0; this -> levels[level].size () > 1; level++ ) {
+		std::vector<Hash256> &nodes = this -> levels[level];
+		size_t parent = position / 2;
+		size_t children = std::min ( nodes.size () - 2 * parent, (size_t) 2 );
+
+		// The pair is stored contiguously, so it's hashed in place
+		Hash256 node = crypto::sha256 ( nodes[2 * parent].bytes, children * sizeof ( Hash256 ) );
+
+		if ( this -> levels.size () == level + 1 )
+			this -> levels.emplace_back ();
+
+		std::vector<Hash256> &parents = this -> levels[level + 1];
+		if ( parent == parents.size () )
+			parents.push_back ( node );
+		else
+			parents[parent] = node;
+
+		position = parent;
+	}
+}
+
+/**
+ * Recalculates every node above a leaf or any leaf after it
+ * (Each level's dirty nodes are hashed as one batch)
+ *
+ * @param position - The position of the first leaf which changed
+ */
+void MerkleTree::update_from ( size_t position ) {
+	std::vector<const unsigned char*> inputs;
+	std::vector<size_t> lengths;
+
+	for ( size_t level = 0; this -> levels[level].size () > 1; level++ ) {
+		if ( this -> levels.size () == level + 1 )
+			this -> levels.emplace_back ();
+
+		std::vector<Hash256> &nodes = this -> levels[level];
+		std::vector<Hash256> &parents = this -> levels[level + 1];
+		size_t first = position / 2;
+		size_t count = ( nodes.size () + 1 ) / 2;
+
+		// Hashes each pair in place, or a trailing unpaired node alone
+		inputs.clear ();
+		lengths.clear ();
+		for ( size_t parent = first; parent < count; parent++ ) {
+			inputs.push_back ( nodes[2 * parent].bytes );
+			lengths.push_back ( std::min ( nodes.size () - 2 * parent, (size_t) 2 ) * sizeof ( Hash256 ) );
+		}
+
+		parents.resize ( count );
+		crypto::sha256_many ( inputs.data (), lengths.data (), inputs.size (), parents[first].bytes );
+		position = first;
+	}
+}
@@ -0,0 +1,37 @@
+#pragma once
+#ifndef MERKLE_TREE_H
+#define MERKLE_TREE_H
+
+#include <vector>
+#include "hash256.h"
+#include "crypto.h"
+
+struct MerkleProof {
+	size_t position;
+	size_t leaves;
+	std::vector<Hash256> siblings;
+};
+
+class MerkleTree {
+	public:
+		MerkleTree ();
+
+		size_t size ();
+		void append ( Hash256 leaf );
+		void append ( const std::vector<Hash256> &leaves );
+		void replace ( size_t position, Hash256 leaf );
+		void clear ();
+
+		Hash256 root ();
+
+		MerkleProof proof ( size_t position );
+		static bool verify_proof ( Hash256 leaf, MerkleProof proof, Hash256 root );
+
+	private:
+		std::vector<std::vector<Hash256>> levels;
+
+		void update ( size_t position );
+		void update_from ( size_t position );
+};
+
+#endif
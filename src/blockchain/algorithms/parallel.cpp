@@ -0,0 +1,190 @@
+#include "parallel.h"
+
+namespace parallel {
+
+	/**
+	 * Resolves a requested worker count
+	 *
+	 * @param threads - The requested number of threads (0 uses every available core)
+	 * @returns The number of threads which should be started
+	 */
+	unsigned int resolve_threads ( unsigned int threads ) {
+		if ( threads == 0 )
+			threads = std::thread::hardware_concurrency ();
+
+		return threads == 0 ? 1 : threads;
+	}
+
+	/**
+	 * Checks a predicate for every index in [0, count) across several threads
+	 * (Indices are handed out one at a time so that uneven work stays balanced,
+	 * and the first failure stops every worker. The calling thread works too,
+	 * helped by up to threads - 1 workers of the shared pool)
+	 *
+	 * @param count - The number of indices
+	 * @param threads - The number of threads, the caller's included (0 uses every available core)
+	 * @param predicate - The check which should be run for each index
+	 * @returns Whether or not the predicate held for every index
+	 */
+	bool all_of ( size_t count, unsigned int threads, std::function<bool ( size_t )> predicate ) {
+		threads = std::min ( resolve_threads ( threads ), (unsigned int) std::max ( count, (size_t) 1 ) );
+
+		// Runs on the calling thread alone when there's no point in waking workers
+		return Pool::global ().run ( count, threads - 1, predicate );
+	}
+
+	/**
+	 * Runs a function for every index in [0, count) across several threads
+	 * (Unlike all_of every index is visited, a function which shouldn't stop
+	 * the others must catch its own exceptions)
+	 *
+	 * @param count - The number of indices
+	 * @param threads - The number of worker threads (0 uses every available core)
+	 * @param function - The work which should be done for each index
+	 */
+	void for_each ( size_t count, unsigned int threads, std::function<void ( size_t )> function ) {
+		all_of ( count, threads, [&function] ( size_t x ) {
+			function ( x );
+			return true;
+		} );
+	}
+
+	/**
+	 * Gets the pool shared by every call in the process
+	 *
+	 * @returns The pool
+	 */
+	Pool &Pool::global () {
+		static Pool pool ( resolve_threads ( 0 ) );
+		return pool;
+	}
+
+	/**
+	 * The pool constructor
+	 *
+	 * @param size - The number of workers
+	 */
+	Pool::Pool ( unsigned int size ) {
+		this -> stopping = false;
+
+		for ( unsigned int x = 0; x < size; x++ )
+			this -> workers.emplace_back ( [this] () { this -> help (); } );
+	}
+
+	/**
+	 * The pool destructor
+	 * (Stops every worker once it's done with its current job)
+	 */
+	Pool::~Pool () {
+		{
+			std::lock_guard<std::mutex> lock ( this -> mutex );
+			this -> stopping = true;
+		}
+
+		this -> wake.notify_all ();
+		for ( auto &worker : this -> workers )
+			worker.join ();
+	}
+
+	/**
+	 * Checks a predicate for every index in [0, count) on the calling thread and some of the pool's workers
+	 *
+	 * @param count - The number of indices
+	 * @param helpers - The most workers which may join the caller
+	 * @param predicate - The check which should be run for each index
+	 * @returns Whether or not the predicate held for every index
+	 */
+	bool Pool::run ( size_t count, unsigned int helpers, const std::function<bool ( size_t )> &predicate ) {
+		std::shared_ptr<Job> job = std::make_shared<Job> ();
+		job -> count = count;
+		job -> predicate = &predicate;
+		job -> next = 0;
+		job -> failed = false;
+		job -> wanted = std::min ( helpers, (unsigned int) this -> workers.size () );
+		job -> joined = 0;
+
+		bool is_shared = job -> wanted > 0;
+		bool is_single = job -> wanted == 1;
+		if ( is_shared ) {
+			{
+				std::lock_guard<std::mutex> lock ( this -> mutex );
+				this -> jobs.push_back ( job );
+			}
+
+			if ( is_single )
+				this -> wake.notify_one ();
+			else
+				this -> wake.notify_all ();
+		}
+
+		job -> work ();
+
+		// Withdraws the workers which haven't joined yet, then waits for those which did
+		if ( is_shared ) {
+			{
+				std::lock_guard<std::mutex> lock ( this -> mutex );
+				for ( auto queued = this -> jobs.begin (); queued != this -> jobs.end (); queued++ )
+					if ( *queued == job ) {
+						this -> jobs.erase ( queued );
+						break;
+					}
+			}
+
+			std::unique_lock<std::mutex> lock ( job -> mutex );
+			job -> left.wait ( lock, [&job] () { return job -> joined == 0; } );
+		}
+
+		if ( job -> error )
+			std::rethrow_exception ( job -> error );
+
+		return !( job -> failed );
+	}
+
+	/**
+	 * A worker's loop, joining the oldest job which still wants help
+	 */
+	void Pool::help () {
+		while ( true ) {
+			std::shared_ptr<Job> job;
+			{
+				std::unique_lock<std::mutex> lock ( this -> mutex );
+				this -> wake.wait ( lock, [this] () { return this -> stopping || !( this -> jobs.empty () ); } );
+				if ( this -> stopping )
+					return;
+
+				job = this -> jobs.front ();
+				if ( --job -> wanted == 0 )
+					this -> jobs.pop_front ();
+
+				// Joins under the pool's lock, so the caller can't stop waiting before this worker is counted
+				std::lock_guard<std::mutex> joining ( job -> mutex );
+				job -> joined++;
+			}
+
+			job -> work ();
+
+			std::lock_guard<std::mutex> lock ( job -> mutex );
+			if ( --job -> joined == 0 )
+				job -> left.notify_all ();
+		}
+	}
+
+	/**
+	 * Takes indices from the job until there are none left or one failed
+	 */
+	void Pool::Job::work () {
+		for ( size_t x = this -> next++; x < this -> count && !( this -> failed.load ( std::memory_order_relaxed ) ); x = this -> next++ ) {
+			try {
+				if ( !( *( this -> predicate ) ) ( x ) )
+					this -> failed = true;
+			} catch ( ... ) {
+
+				// Keeps the first exception so that it can be rethrown on the caller's thread
+				std::lock_guard<std::mutex> lock ( this -> mutex );
+				if ( !( this -> error ) )
+					this -> error = std::current_exception ();
+				this -> failed = true;
+			}
+		}
+	}
+}
@@ -0,0 +1,63 @@
+#pragma once
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <deque>
+#include <memory>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+
+namespace parallel {
+	unsigned int resolve_threads ( unsigned int threads );
+	bool all_of ( size_t count, unsigned int threads, std::function<bool ( size_t )> predicate );
+	void for_each ( size_t count, unsigned int threads, std::function<void ( size_t )> function );
+
+	/**
+	 * The worker threads shared by every all_of and for_each call
+	 * (Started on first use, with one worker per core. The caller of a job
+	 * always works on it too, and only waits for the workers which joined in,
+	 * so a job finishes even when every worker is busy and calls can be nested)
+	 */
+	class Pool {
+		public:
+			static Pool &global ();
+
+			bool run ( size_t count, unsigned int helpers, const std::function<bool ( size_t )> &predicate );
+
+			~Pool ();
+
+		private:
+			struct Job {
+				size_t count;
+				const std::function<bool ( size_t )> *predicate;
+				std::atomic<size_t> next;
+				std::atomic<bool> failed;
+				std::exception_ptr error;
+				unsigned int wanted;
+				unsigned int joined;
+				std::mutex mutex;
+				std::condition_variable left;
+
+				void work ();
+			};
+
+			std::mutex mutex;
+			std::condition_variable wake;
+			std::deque<std::shared_ptr<Job>> jobs;
+			std::vector<std::thread> workers;
+			bool stopping;
+
+			Pool ( unsigned int size );
+			Pool ( const Pool & ) = delete;
+			Pool &operator= ( const Pool & ) = delete;
+
+			void help ();
+	};
+}
+
+#endif
@@ -4,40 +4,54 @@ namespace search {
 
 	/**
 	 * An implementation of binary search to find transactions in the blockchain based on their index
+	 * (Only the header index is searched, the block holding the transaction is read straight from the store)
 	 *
-	 * @param blocks - A vector containing all the blocks
-	 * @param begin - The begin iterator of the vector
-	 * @param end - The end iterator of the vector
+	 * @param blocks - The stored blocks
 	 * @param tx_index - The transaction index
 	 * @returns The transaction
 	 */
-	Transaction binary_search ( std::vector<Block> blocks, std::vector<Block>::iterator begin, std::vector<Block>::iterator end, long tx_index ) {
+	Transaction binary_search ( const BlockStore &blocks, long tx_index ) {
 
-		// Gets the middle block
-		Block middle = *( begin + (int)( ( end - begin ) / 2 ) );
+		size_t begin = 0;
+		size_t end = blocks.size ();
+		while ( begin < end ) {
 
-		// Checks if the transaction index is less than the block's index
-		if ( tx_index < middle.index ) {
+			// Gets the middle block
+			size_t middle = begin + ( end - begin ) / 2;
+			const BlockHeader &header = blocks.header ( middle );
 
-			// Searches the left hash of the binary tree
-			return binary_search ( blocks, begin, begin + (int)( ( end - begin ) / 2 ), tx_index );
-		}
+			// Checks if the transaction index is less than the block's index
+			if ( tx_index < header.index ) {
 
-		if ( tx_index > middle.index ) {
+				// Searches the left half
+				end = middle;
+				continue;
+			}
 
 			// Checks if the index is in the block's range 
-			if ( (long) middle.transactions.size () > tx_index - middle.index ) { 
+			if ( tx_index - header.index < (long) header.transactions ) {
 
 				// The transaction is in the block
-				return middle.transactions.at ( tx_index - middle.index );
+				return blocks.view ( middle ).transaction ( tx_index - header.index ).to_transaction ();
 			}
 
-			// Searches the right half of the tree
-			return binary_search ( blocks, begin + (int)( ( end - begin ) / 2 ), end, tx_index );
+			// Searches the right half
+			begin = middle + 1;
 		}
 
-		return middle.transactions.front ();
+		throw std::runtime_error ( "Transaction not found!" );
+	}
 
+	/**
+	 * Finds a transaction by index in a snapshot of the chain
+	 * (Safe to call while the chain is being extended)
+	 *
+	 * @param snapshot - The snapshot
+	 * @param tx_index - The transaction index
+	 * @returns The transaction
+	 */
+	Transaction binary_search ( const ChainSnapshot &snapshot, long tx_index ) {
+		return snapshot.get_transaction ( tx_index ).to_transaction ();
 	}
 
-}
\ No newline at end of file
+}
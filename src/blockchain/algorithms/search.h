@@ -6,10 +6,13 @@
 #include <iostream>
 #include <math.h>
 #include "block.h"
+#include "block_store.h"
+#include "chain_snapshot.h"
 #include "transaction.h"
 
 namespace search {
-	Transaction binary_search ( std::vector<Block> blocks, std::vector<Block>::iterator begin, std::vector<Block>::iterator end, long tx_index );
+	Transaction binary_search ( const BlockStore &blocks, long tx_index );
+	Transaction binary_search ( const ChainSnapshot &snapshot, long tx_index );
 }
 
 #endif
\ No newline at end of file
@@ -0,0 +1,279 @@
+#include "serialize.h"
+
+namespace serialize {
+
+	/**
+	* Copies the span into a string
+	*
+	* @returns The span's bytes
+	*/
+	std::string Span::to_string () const {
+		return std::string ( reinterpret_cast<const char*> ( this -> data ), this -> size );
+	}
+
+	bool Span::operator== ( const Span &other ) const {
+		return this -> size == other.size && ( this -> size == 0 || std::memcmp ( this -> data, other.data, this -> size ) == 0 );
+	}
+
+	bool Span::operator== ( const std::string &other ) const {
+		return this -> size == other.size () && ( this -> size == 0 || std::memcmp ( this -> data, other.data (), this -> size ) == 0 );
+	}
+
+	/**
+	* Calculates the CRC-32 (IEEE) of some bytes, which catches torn and
+	* corrupted records cheaply
+	*
+	* @param data - The bytes
+	* @param length - The number of bytes
+	* @returns The checksum
+	*/
+	uint32_t crc32 ( const unsigned char *data, size_t length ) {
+		static const std::array<uint32_t, 256> table = [] () {
+			std::array<uint32_t, 256> table;
+			for ( uint32_t x = 0; x < 256; x++ ) {
+				uint32_t value = x;
+				for ( int bit = 0; bit < 8; bit++ )
+					value = value & 1 ? 0xEDB88320 ^ ( value >> 1 ) : value >> 1;
+
+				table[x] = value;
+			}
+
+			return table;
+		} ();
+
+		uint32_t crc = 0xFFFFFFFF;
+		for ( size_t x = 0; x < length; x++ )
+			crc = table[( crc ^ data[x] ) & 0xFF] ^ ( crc >> 8 );
+
+		return crc ^ 0xFFFFFFFF;
+	}
+
+	/**
+	* Reads a little endian 32 bit integer
+	*
+	* @param data - The 4 bytes which should be read
+	* @returns The integer
+	*/
+	uint32_t read_u32 ( const unsigned char *data ) {
+		return (uint32_t) data[0] | (uint32_t) data[1] << 8 | (uint32_t) data[2] << 16 | (uint32_t) data[3] << 24;
+	}
+
+	/**
+	* Reads a little endian 64 bit integer
+	*
+	* @param data - The 8 bytes which should be read
+	* @returns The integer
+	*/
+	uint64_t read_u64 ( const unsigned char *data ) {
+		return (uint64_t) read_u32 ( data ) | (uint64_t) read_u32 ( data + 4 ) << 32;
+	}
+
+	/**
+	* Creates a writer which only measures the encoding
+	*/
+	Writer::Writer () : Writer ( nullptr, 0 ) {}
+
+	/**
+	* The writer constructor
+	*
+	* @param buffer - The buffer which recieves the encoding
+	* @param capacity - The size of the buffer
+	*/
+	Writer::Writer ( unsigned char *buffer, size_t capacity ) {
+		this -> buffer = buffer;
+		this -> capacity = capacity;
+		this -> position = 0;
+	}
+
+	void Writer::put ( size_t position, const void *data, size_t length ) {
+		if ( length != 0 && position + length <= this -> capacity )
+			std::memcpy ( this -> buffer + position, data, length );
+	}
+
+	void Writer::u8 ( uint8_t value ) {
+		this -> raw ( &value, 1 );
+	}
+
+	void Writer::u32 ( uint32_t value ) {
+		unsigned char bytes[4];
+		for ( int x = 0; x < 4; x++ )
+			bytes[x] = (unsigned char)( value >> ( 8 * x ) );
+
+		this -> raw ( bytes, sizeof ( bytes ) );
+	}
+
+	void Writer::u64 ( uint64_t value ) {
+		unsigned char bytes[8];
+		for ( int x = 0; x < 8; x++ )
+			bytes[x] = (unsigned char)( value >> ( 8 * x ) );
+
+		this -> raw ( bytes, sizeof ( bytes ) );
+	}
+
+	void Writer::i64 ( int64_t value ) {
+		this -> u64 ( (uint64_t) value );
+	}
+
+	void Writer::hash ( const Hash256 &hash ) {
+		this -> raw ( hash.bytes, sizeof ( hash.bytes ) );
+	}
+
+	/**
+	* Writes bytes as they are, without a length
+	*
+	* @param data - The bytes
+	* @param length - The number of bytes
+	*/
+	void Writer::raw ( const void *data, size_t length ) {
+		this -> put ( this -> position, data, length );
+		this -> position += length;
+	}
+
+	/**
+	* Writes a 32 bit length followed by the bytes
+	*
+	* @param data - The bytes
+	* @param length - The number of bytes
+	*/
+	void Writer::bytes ( const void *data, size_t length ) {
+		if ( length > UINT32_MAX )
+			throw std::runtime_error ( "Field is too large to serialize!" );
+
+		this -> u32 ( (uint32_t) length );
+		this -> raw ( data, length );
+	}
+
+	void Writer::bytes ( const std::string &data ) {
+		this -> bytes ( data.data (), data.size () );
+	}
+
+	/**
+	* Reserves a 32 bit length for a nested encoding which hasn't been written yet
+	*
+	* @returns The position which should be passed to end_length
+	*/
+	size_t Writer::begin_length () {
+		size_t position = this -> position;
+		this -> u32 ( 0 );
+		return position;
+	}
+
+	/**
+	* Fills in a length reserved by begin_length with everything written since
+	*
+	* @param position - The reserved length's position
+	*/
+	void Writer::end_length ( size_t position ) {
+		size_t length = this -> position - position - 4;
+		if ( length > UINT32_MAX )
+			throw std::runtime_error ( "Field is too large to serialize!" );
+
+		unsigned char bytes[4];
+		for ( int x = 0; x < 4; x++ )
+			bytes[x] = (unsigned char)( length >> ( 8 * x ) );
+
+		this -> put ( position, bytes, sizeof ( bytes ) );
+	}
+
+	/**
+	* Gets the length of the encoding so far (including anything past the buffer)
+	*
+	* @returns The number of bytes written
+	*/
+	size_t Writer::size () const {
+		return this -> position;
+	}
+
+	/**
+	* Checks whether the encoding didn't fit in the buffer
+	*
+	* @returns Whether or not bytes were dropped
+	*/
+	bool Writer::overflowed () const {
+		return this -> position > this -> capacity;
+	}
+
+	/**
+	* The reader constructor
+	*
+	* @param data - The encoded bytes
+	* @param size - The number of encoded bytes
+	*/
+	Reader::Reader ( const unsigned char *data, size_t size ) {
+		this -> data = data;
+		this -> size = size;
+		this -> offset = 0;
+	}
+
+	Reader::Reader ( Span span ) : Reader ( span.data, span.size ) {}
+
+	const unsigned char *Reader::take ( size_t length ) {
+		if ( length > this -> size - this -> offset )
+			throw std::runtime_error ( "Truncated serialized data!" );
+
+		const unsigned char *start = this -> data + this -> offset;
+		this -> offset += length;
+		return start;
+	}
+
+	uint8_t Reader::u8 () {
+		return *this -> take ( 1 );
+	}
+
+	uint32_t Reader::u32 () {
+		return read_u32 ( this -> take ( 4 ) );
+	}
+
+	uint64_t Reader::u64 () {
+		return read_u64 ( this -> take ( 8 ) );
+	}
+
+	int64_t Reader::i64 () {
+		return (int64_t) this -> u64 ();
+	}
+
+	Hash256 Reader::hash () {
+		Hash256 hash;
+		std::memcpy ( hash.bytes, this -> take ( sizeof ( hash.bytes ) ), sizeof ( hash.bytes ) );
+		return hash;
+	}
+
+	/**
+	* Reads a fixed number of bytes
+	*
+	* @param length - The number of bytes
+	* @returns A span over the bytes
+	*/
+	Span Reader::raw ( size_t length ) {
+		return Span { this -> take ( length ), length };
+	}
+
+	/**
+	* Reads a length prefixed field
+	*
+	* @returns A span over the field's bytes
+	*/
+	Span Reader::bytes () {
+		return this -> raw ( this -> u32 () );
+	}
+
+	void Reader::skip ( size_t length ) {
+		this -> take ( length );
+	}
+
+	/**
+	* Reads an encoding version, rejecting versions this build doesn't understand
+	*/
+	void Reader::version () {
+		if ( this -> u8 () != VERSION )
+			throw std::runtime_error ( "Unsupported serialization version!" );
+	}
+
+	size_t Reader::position () const {
+		return this -> offset;
+	}
+
+	size_t Reader::remaining () const {
+		return this -> size - this -> offset;
+	}
+}
@@ -0,0 +1,113 @@
+#pragma once
+#ifndef SERIALIZE_H
+#define SERIALIZE_H
+
+#include <array>
+#include <string>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include "hash256.h"
+
+namespace serialize {
+
+	// The current encoding version, written at the start of every block and transaction
+	const uint8_t VERSION = 1;
+
+	/**
+	 * A read-only range of bytes owned by someone else
+	 */
+	struct Span {
+		const unsigned char *data;
+		size_t size;
+
+		std::string to_string () const;
+		bool operator== ( const Span &other ) const;
+		bool operator== ( const std::string &other ) const;
+	};
+
+	/**
+	 * Writes a little endian, length prefixed encoding into a caller supplied buffer
+	 * (Writing past the end of the buffer only counts the bytes, so a writer
+	 * without a buffer can be used to measure an encoding before allocating)
+	 */
+	class Writer {
+		public:
+			Writer ();
+			Writer ( unsigned char *buffer, size_t capacity );
+
+			void u8 ( uint8_t value );
+			void u32 ( uint32_t value );
+			void u64 ( uint64_t value );
+			void i64 ( int64_t value );
+			void hash ( const Hash256 &hash );
+			void raw ( const void *data, size_t length );
+			void bytes ( const void *data, size_t length );
+			void bytes ( const std::string &data );
+
+			size_t begin_length ();
+			void end_length ( size_t position );
+
+			size_t size () const;
+			bool overflowed () const;
+
+		private:
+			unsigned char *buffer;
+			size_t capacity;
+			size_t position;
+
+			void put ( size_t position, const void *data, size_t length );
+	};
+
+	/**
+	 * Reads an encoding written by Writer, without copying variable length fields
+	 */
+	class Reader {
+		public:
+			Reader ( const unsigned char *data, size_t size );
+			Reader ( Span span );
+
+			uint8_t u8 ();
+			uint32_t u32 ();
+			uint64_t u64 ();
+			int64_t i64 ();
+			Hash256 hash ();
+			Span raw ( size_t length );
+			Span bytes ();
+			void skip ( size_t length );
+			void version ();
+
+			size_t position () const;
+			size_t remaining () const;
+
+		private:
+			const unsigned char *data;
+			size_t size;
+			size_t offset;
+
+			const unsigned char *take ( size_t length );
+	};
+
+	uint32_t read_u32 ( const unsigned char *data );
+	uint64_t read_u64 ( const unsigned char *data );
+	uint32_t crc32 ( const unsigned char *data, size_t length );
+
+	/**
+	 * Runs an encoder once to measure it and once more into an exactly sized string
+	 *
+	 * @param encode - A callable which writes the encoding into the given Writer
+	 * @returns The encoded bytes
+	 */
+	template <typename Encode>
+	std::string to_bytes ( Encode encode ) {
+		Writer counter;
+		encode ( counter );
+
+		std::string bytes ( counter.size (), '\0' );
+		Writer writer ( reinterpret_cast<unsigned char*> ( &bytes[0] ), bytes.size () );
+		encode ( writer );
+		return bytes;
+	}
+}
+
+#endif
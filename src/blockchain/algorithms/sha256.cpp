@@ -0,0 +1,699 @@
+#include "sha256.h"
+
+#if defined ( __x86_64__ ) || defined ( __i386__ )
+#define SHA256_X86
+#include <immintrin.h>
+#include <cpuid.h>
+#endif
+
+namespace crypto {
+
+	static const uint32_t K[64] = {
+		0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+		0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+		0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+		0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+		0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+		0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+		0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+		0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+	};
+
+	static const uint32_t H0[8] = {
+		0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+	};
+
+	static inline uint32_t load_be32 ( const unsigned char *buffer ) {
+		return ( (uint32_t) buffer[0] << 24 ) | ( (uint32_t) buffer[1] << 16 ) | ( (uint32_t) buffer[2] << 8 ) | (uint32_t) buffer[3];
+	}
+
+	static inline void store_be32 ( unsigned char *buffer, uint32_t value ) {
+		buffer[0] = (unsigned char)( value >> 24 );
+		buffer[1] = (unsigned char)( value >> 16 );
+		buffer[2] = (unsigned char)( value >> 8 );
+		buffer[3] = (unsigned char) value;
+	}
+
+	static inline uint32_t rotr ( uint32_t x, int n ) {
+		return ( x >> n ) | ( x << ( 32 - n ) );
+	}
+
+	/**
+	* Compresses a single block (portable fallback)
+	*
+	* @param state - The 8 word hashing state which is updated in place
+	* @param block - The 64 byte block
+	*/
+	static void transform_scalar ( uint32_t *state, const unsigned char *block ) {
+		uint32_t w[64];
+		for ( int t = 0; t < 16; t++ )
+			w[t] = load_be32 ( block + 4 * t );
+
+		for ( int t = 16; t < 64; t++ )
+			w[t] = ( rotr ( w[t - 2], 17 ) ^ rotr ( w[t - 2], 19 ) ^ ( w[t - 2] >> 10 ) ) + w[t - 7]
+				+ ( rotr ( w[t - 15], 7 ) ^ rotr ( w[t - 15], 18 ) ^ ( w[t - 15] >> 3 ) ) + w[t - 16];
+
+		uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+		uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+
+		for ( int t = 0; t < 64; t++ ) {
+			uint32_t t1 = h + ( rotr ( e, 6 ) ^ rotr ( e, 11 ) ^ rotr ( e, 25 ) ) + ( ( e & f ) ^ ( ~e & g ) ) + K[t] + w[t];
+			uint32_t t2 = ( rotr ( a, 2 ) ^ rotr ( a, 13 ) ^ rotr ( a, 22 ) ) + ( ( a & b ) ^ ( a & c ) ^ ( b & c ) );
+			h = g;
+			g = f;
+			f = e;
+			e = d + t1;
+			d = c;
+			c = b;
+			b = a;
+			a = t1 + t2;
+		}
+
+		state[0] += a; state[1] += b; state[2] += c; state[3] += d;
+		state[4] += e; state[5] += f; state[6] += g; state[7] += h;
+	}
+
+#ifdef SHA256_X86
+
+	/* 4 lane SSE4 kernel (one independent message per 32 bit lane) */
+
+	__attribute__ (( target ( "sse4.1" ) )) static inline __m128i rotr_sse4 ( __m128i x, int n ) {
+		return _mm_or_si128 ( _mm_srli_epi32 ( x, n ), _mm_slli_epi32 ( x, 32 - n ) );
+	}
+
+	__attribute__ (( target ( "sse4.1" ) )) static inline __m128i add_sse4 ( __m128i x, __m128i y ) {
+		return _mm_add_epi32 ( x, y );
+	}
+
+	/**
+	* Compresses one block for each of 4 independent messages
+	*
+	* @param states - The 4 hashing states which are updated in place
+	* @param blocks - The 4 blocks
+	*/
+	__attribute__ (( target ( "sse4.1" ) )) static void transform_sse4 ( uint32_t *const *states, const unsigned char *const *blocks ) {
+		__m128i w[16];
+		for ( int t = 0; t < 16; t++ )
+			w[t] = _mm_set_epi32 ( load_be32 ( blocks[3] + 4 * t ), load_be32 ( blocks[2] + 4 * t ), load_be32 ( blocks[1] + 4 * t ), load_be32 ( blocks[0] + 4 * t ) );
+
+		__m128i s[8];
+		for ( int x = 0; x < 8; x++ )
+			s[x] = _mm_set_epi32 ( states[3][x], states[2][x], states[1][x], states[0][x] );
+
+		__m128i a = s[0], b = s[1], c = s[2], d = s[3], e = s[4], f = s[5], g = s[6], h = s[7];
+
+		for ( int t = 0; t < 64; t++ ) {
+
+			// Expands the message schedule in a 16 word ring
+			if ( t >= 16 ) {
+				__m128i w2 = w[( t - 2 ) & 15], w15 = w[( t - 15 ) & 15];
+				__m128i sigma1 = _mm_xor_si128 ( _mm_xor_si128 ( rotr_sse4 ( w2, 17 ), rotr_sse4 ( w2, 19 ) ), _mm_srli_epi32 ( w2, 10 ) );
+				__m128i sigma0 = _mm_xor_si128 ( _mm_xor_si128 ( rotr_sse4 ( w15, 7 ), rotr_sse4 ( w15, 18 ) ), _mm_srli_epi32 ( w15, 3 ) );
+				w[t & 15] = add_sse4 ( add_sse4 ( sigma1, w[( t - 7 ) & 15] ), add_sse4 ( sigma0, w[t & 15] ) );
+			}
+
+			__m128i big_sigma1 = _mm_xor_si128 ( _mm_xor_si128 ( rotr_sse4 ( e, 6 ), rotr_sse4 ( e, 11 ) ), rotr_sse4 ( e, 25 ) );
+			__m128i ch = _mm_xor_si128 ( _mm_and_si128 ( e, f ), _mm_andnot_si128 ( e, g ) );
+			__m128i t1 = add_sse4 ( add_sse4 ( add_sse4 ( h, big_sigma1 ), add_sse4 ( ch, _mm_set1_epi32 ( K[t] ) ) ), w[t & 15] );
+
+			__m128i big_sigma0 = _mm_xor_si128 ( _mm_xor_si128 ( rotr_sse4 ( a, 2 ), rotr_sse4 ( a, 13 ) ), rotr_sse4 ( a, 22 ) );
+			__m128i maj = _mm_or_si128 ( _mm_and_si128 ( _mm_or_si128 ( a, b ), c ), _mm_and_si128 ( a, b ) );
+			__m128i t2 = add_sse4 ( big_sigma0, maj );
+
+			h = g;
+			g = f;
+			f = e;
+			e = add_sse4 ( d, t1 );
+			d = c;
+			c = b;
+			b = a;
+			a = add_sse4 ( t1, t2 );
+		}
+
+		__m128i result[8] = { a, b, c, d, e, f, g, h };
+		alignas ( 16 ) uint32_t lanes[4];
+		for ( int x = 0; x < 8; x++ ) {
+			_mm_store_si128 ( (__m128i*) lanes, add_sse4 ( s[x], result[x] ) );
+			for ( int lane = 0; lane < 4; lane++ )
+				states[lane][x] = lanes[lane];
+		}
+	}
+
+	/* 8 lane AVX2 kernel (one independent message per 32 bit lane) */
+
+	__attribute__ (( target ( "avx2" ) )) static inline __m256i rotr_avx2 ( __m256i x, int n ) {
+		return _mm256_or_si256 ( _mm256_srli_epi32 ( x, n ), _mm256_slli_epi32 ( x, 32 - n ) );
+	}
+
+	__attribute__ (( target ( "avx2" ) )) static inline __m256i add_avx2 ( __m256i x, __m256i y ) {
+		return _mm256_add_epi32 ( x, y );
+	}
+
+	/**
+	* Compresses one block for each of 8 independent messages
+	*
+	* @param states - The 8 hashing states which are updated in place
+	* @param blocks - The 8 blocks
+	*/
+	__attribute__ (( target ( "avx2" ) )) static void transform_avx2 ( uint32_t *const *states, const unsigned char *const *blocks ) {
+		__m256i w[16];
+		for ( int t = 0; t < 16; t++ )
+			w[t] = _mm256_set_epi32 (
+				load_be32 ( blocks[7] + 4 * t ), load_be32 ( blocks[6] + 4 * t ), load_be32 ( blocks[5] + 4 * t ), load_be32 ( blocks[4] + 4 * t ),
+				load_be32 ( blocks[3] + 4 * t ), load_be32 ( blocks[2] + 4 * t ), load_be32 ( blocks[1] + 4 * t ), load_be32 ( blocks[0] + 4 * t ) );
+
+		__m256i s[8];
+		for ( int x = 0; x < 8; x++ )
+			s[x] = _mm256_set_epi32 ( states[7][x], states[6][x], states[5][x], states[4][x], states[3][x], states[2][x], states[1][x], states[0][x] );
+
+		__m256i a = s[0], b = s[1], c = s[2], d = s[3], e = s[4], f = s[5], g = s[6], h = s[7];
+
+		for ( int t = 0; t < 64; t++ ) {
+
+			// Expands the message schedule in a 16 word ring
+			if ( t >= 16 ) {
+				__m256i w2 = w[( t - 2 ) & 15], w15 = w[( t - 15 ) & 15];
+				__m256i sigma1 = _mm256_xor_si256 ( _mm256_xor_si256 ( rotr_avx2 ( w2, 17 ), rotr_avx2 ( w2, 19 ) ), _mm256_srli_epi32 ( w2, 10 ) );
+				__m256i sigma0 = _mm256_xor_si256 ( _mm256_xor_si256 ( rotr_avx2 ( w15, 7 ), rotr_avx2 ( w15, 18 ) ), _mm256_srli_epi32 ( w15, 3 ) );
+				w[t & 15] = add_avx2 ( add_avx2 ( sigma1, w[( t - 7 ) & 15] ), add_avx2 ( sigma0, w[t & 15] ) );
+			}
+
+			__m256i big_sigma1 = _mm256_xor_si256 ( _mm256_xor_si256 ( rotr_avx2 ( e, 6 ), rotr_avx2 ( e, 11 ) ), rotr_avx2 ( e, 25 ) );
+			__m256i ch = _mm256_xor_si256 ( _mm256_and_si256 ( e, f ), _mm256_andnot_si256 ( e, g ) );
+			__m256i t1 = add_avx2 ( add_avx2 ( add_avx2 ( h, big_sigma1 ), add_avx2 ( ch, _mm256_set1_epi32 ( K[t] ) ) ), w[t & 15] );
+
+			__m256i big_sigma0 = _mm256_xor_si256 ( _mm256_xor_si256 ( rotr_avx2 ( a, 2 ), rotr_avx2 ( a, 13 ) ), rotr_avx2 ( a, 22 ) );
+			__m256i maj = _mm256_or_si256 ( _mm256_and_si256 ( _mm256_or_si256 ( a, b ), c ), _mm256_and_si256 ( a, b ) );
+			__m256i t2 = add_avx2 ( big_sigma0, maj );
+
+			h = g;
+			g = f;
+			f = e;
+			e = add_avx2 ( d, t1 );
+			d = c;
+			c = b;
+			b = a;
+			a = add_avx2 ( t1, t2 );
+		}
+
+		__m256i result[8] = { a, b, c, d, e, f, g, h };
+		alignas ( 32 ) uint32_t lanes[8];
+		for ( int x = 0; x < 8; x++ ) {
+			_mm256_store_si256 ( (__m256i*) lanes, add_avx2 ( s[x], result[x] ) );
+			for ( int lane = 0; lane < 8; lane++ )
+				states[lane][x] = lanes[lane];
+		}
+	}
+
+	/* Single block SHA extensions kernel */
+
+	/**
+	* Compresses a single block with the SHA-NI instructions
+	*
+	* @param state - The 8 word hashing state which is updated in place
+	* @param block - The 64 byte block
+	*/
+	__attribute__ (( target ( "sha,sse4.1" ) )) static void transform_shani ( uint32_t *state, const unsigned char *block ) {
+		const __m128i mask = _mm_set_epi64x ( 0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL );
+
+		// Rearranges the state into the ABEF / CDGH layout used by the instructions
+		__m128i tmp = _mm_shuffle_epi32 ( _mm_loadu_si128 ( (const __m128i*) &state[0] ), 0xB1 );
+		__m128i state1 = _mm_shuffle_epi32 ( _mm_loadu_si128 ( (const __m128i*) &state[4] ), 0x1B );
+		__m128i state0 = _mm_alignr_epi8 ( tmp, state1, 8 );
+		state1 = _mm_blend_epi16 ( state1, tmp, 0xF0 );
+
+		__m128i abef = state0;
+		__m128i cdgh = state1;
+
+		__m128i w[4];
+		for ( int x = 0; x < 16; x++ ) {
+
+			// Loads or expands the next 4 message words
+			if ( x < 4 )
+				w[x] = _mm_shuffle_epi8 ( _mm_loadu_si128 ( (const __m128i*)( block + 16 * x ) ), mask );
+			else {
+				__m128i next = _mm_sha256msg1_epu32 ( w[x & 3], w[( x + 1 ) & 3] );
+				next = _mm_add_epi32 ( next, _mm_alignr_epi8 ( w[( x + 3 ) & 3], w[( x + 2 ) & 3], 4 ) );
+				w[x & 3] = _mm_sha256msg2_epu32 ( next, w[( x + 3 ) & 3] );
+			}
+
+			__m128i message = _mm_add_epi32 ( w[x & 3], _mm_loadu_si128 ( (const __m128i*) &K[4 * x] ) );
+			state1 = _mm_sha256rnds2_epu32 ( state1, state0, message );
+			state0 = _mm_sha256rnds2_epu32 ( state0, state1, _mm_shuffle_epi32 ( message, 0x0E ) );
+		}
+
+		state0 = _mm_add_epi32 ( state0, abef );
+		state1 = _mm_add_epi32 ( state1, cdgh );
+
+		// Restores the ABCD / EFGH layout
+		tmp = _mm_shuffle_epi32 ( state0, 0x1B );
+		state1 = _mm_shuffle_epi32 ( state1, 0xB1 );
+		_mm_storeu_si128 ( (__m128i*) &state[0], _mm_blend_epi16 ( tmp, state1, 0xF0 ) );
+		_mm_storeu_si128 ( (__m128i*) &state[4], _mm_alignr_epi8 ( state1, tmp, 8 ) );
+	}
+
+#endif
+
+	/**
+	* Runs a multi lane kernel over any number of messages, filling the last
+	* group with throwaway lanes
+	*
+	* @param kernel - The multi lane kernel
+	* @param lanes - The kernel's lane count
+	* @param states - The hashing states
+	* @param blocks - The blocks
+	* @param count - The number of states and blocks
+	*/
+	static void transform_lanes ( void ( *kernel ) ( uint32_t *const *, const unsigned char *const * ), size_t lanes, uint32_t *const *states, const unsigned char *const *blocks, size_t count ) {
+		for ( size_t x = 0; x < count; x += lanes ) {
+
+			if ( count - x >= lanes ) {
+				kernel ( states + x, blocks + x );
+				continue;
+			}
+
+			uint32_t scratch[8][8];
+			uint32_t *group_states[8];
+			const unsigned char *group_blocks[8];
+			for ( size_t lane = 0; lane < lanes; lane++ ) {
+				if ( x + lane < count ) {
+					group_states[lane] = states[x + lane];
+					group_blocks[lane] = blocks[x + lane];
+				} else {
+					std::memcpy ( scratch[lane], states[x], sizeof ( scratch[lane] ) );
+					group_states[lane] = scratch[lane];
+					group_blocks[lane] = blocks[x];
+				}
+			}
+
+			kernel ( group_states, group_blocks );
+		}
+	}
+
+	/**
+	* Checks whether the CPU can run a given backend
+	*
+	* @param backend - The backend
+	* @returns Whether or not the backend is supported
+	*/
+	bool sha256_supported ( Sha256Backend backend ) {
+		switch ( backend ) {
+			case Sha256Backend::SCALAR:
+				return true;
+#ifdef SHA256_X86
+			case Sha256Backend::SSE4:
+				return __builtin_cpu_supports ( "sse4.1" );
+			case Sha256Backend::AVX2:
+				return __builtin_cpu_supports ( "avx2" );
+			case Sha256Backend::SHANI: {
+				unsigned int eax, ebx, ecx, edx;
+				if ( !__get_cpuid_count ( 7, 0, &eax, &ebx, &ecx, &edx ) )
+					return false;
+
+				return ( ebx & ( 1 << 29 ) ) && __builtin_cpu_supports ( "sse4.1" );
+			}
+#endif
+			default:
+				return false;
+		}
+	}
+
+	/**
+	* Checks whether the CPU can run a given backend, probing the CPU only once
+	* (cpuid serializes the pipeline and traps under some hypervisors, so it's
+	* kept out of the hashing loops)
+	*
+	* @param backend - The backend
+	* @returns Whether or not the backend is supported
+	*/
+	static bool is_supported ( Sha256Backend backend ) {
+		static const bool supported[] = {
+			sha256_supported ( Sha256Backend::SCALAR ),
+			sha256_supported ( Sha256Backend::SSE4 ),
+			sha256_supported ( Sha256Backend::AVX2 ),
+			sha256_supported ( Sha256Backend::SHANI )
+		};
+
+		return supported[(int) backend];
+	}
+
+	/**
+	* Gets a backend's display name
+	*
+	* @param backend - The backend
+	* @returns The backend's name
+	*/
+	std::string sha256_backend_name ( Sha256Backend backend ) {
+		switch ( backend ) {
+			case Sha256Backend::SSE4:
+				return "SSE4 (4 lanes)";
+			case Sha256Backend::AVX2:
+				return "AVX2 (8 lanes)";
+			case Sha256Backend::SHANI:
+				return "SHA-NI";
+			default:
+				return "Scalar";
+		}
+	}
+
+	/**
+	* Selects the fastest backend which the CPU supports and which agrees with OpenSSL
+	*
+	* @returns The selected backend
+	*/
+	static Sha256Backend select_backend () {
+		for ( auto backend : { Sha256Backend::SHANI, Sha256Backend::AVX2, Sha256Backend::SSE4 } )
+			if ( sha256_supported ( backend ) && sha256_self_test ( backend ) )
+				return backend;
+
+		return Sha256Backend::SCALAR;
+	}
+
+	/**
+	* Gets the backend used by every hashing function without an explicit backend
+	* (Selected once, on first use)
+	*
+	* @returns The selected backend
+	*/
+	Sha256Backend sha256_backend () {
+		static const Sha256Backend backend = select_backend ();
+		return backend;
+	}
+
+	/**
+	* Gets the backend used for a single stream of blocks
+	* (The lane kernels only pay off with several independent messages)
+	*
+	* @returns The single stream backend
+	*/
+	static Sha256Backend single_backend () {
+		return sha256_backend () == Sha256Backend::SHANI ? Sha256Backend::SHANI : Sha256Backend::SCALAR;
+	}
+
+	/**
+	* Compresses a single block
+	*
+	* @param backend - The backend which should be used
+	* @param state - The 8 word hashing state which is updated in place
+	* @param block - The 64 byte block
+	*/
+	void sha256_transform ( Sha256Backend backend, uint32_t *state, const unsigned char *block ) {
+#ifdef SHA256_X86
+		if ( backend == Sha256Backend::SHANI ) {
+			transform_shani ( state, block );
+			return;
+		}
+#endif
+		transform_scalar ( state, block );
+	}
+
+	/**
+	* Compresses one block for each of several independent messages
+	*
+	* @param backend - The backend which should be used
+	* @param states - The hashing states which are updated in place
+	* @param blocks - One 64 byte block per state
+	* @param count - The number of states and blocks
+	*/
+	void sha256_transform_many ( Sha256Backend backend, uint32_t *const *states, const unsigned char *const *blocks, size_t count ) {
+		if ( !is_supported ( backend ) )
+			throw std::runtime_error ( "Unsupported SHA256 backend!" );
+
+		switch ( backend ) {
+#ifdef SHA256_X86
+			case Sha256Backend::SSE4:
+				transform_lanes ( transform_sse4, 4, states, blocks, count );
+				return;
+			case Sha256Backend::AVX2:
+				transform_lanes ( transform_avx2, 8, states, blocks, count );
+				return;
+#endif
+			default:
+				for ( size_t x = 0; x < count; x++ )
+					sha256_transform ( backend, states[x], blocks[x] );
+		}
+	}
+
+	/**
+	* Absorbs data into a hashing state
+	*
+	* @param midstate - The hashing state
+	* @param input - The data
+	* @param length - The length of the data
+	*/
+	static void update ( sha256_midstate &midstate, const unsigned char *input, size_t length ) {
+		Sha256Backend backend = single_backend ();
+		midstate.length += length;
+
+		// Completes the buffered block
+		if ( midstate.buffered > 0 ) {
+			size_t fill = std::min ( length, sizeof ( midstate.buffer ) - midstate.buffered );
+			std::memcpy ( midstate.buffer + midstate.buffered, input, fill );
+			midstate.buffered += fill;
+			input += fill;
+			length -= fill;
+
+			if ( midstate.buffered < sizeof ( midstate.buffer ) )
+				return;
+
+			sha256_transform ( backend, midstate.state, midstate.buffer );
+			midstate.buffered = 0;
+		}
+
+		for ( ; length >= 64; input += 64, length -= 64 )
+			sha256_transform ( backend, midstate.state, input );
+
+		std::memcpy ( midstate.buffer, input, length );
+		midstate.buffered = length;
+	}
+
+	/**
+	* Writes the padding and length of a message after its buffered tail
+	*
+	* @param midstate - The hashing state
+	* @param blocks - The 128 byte buffer which recieves the final blocks
+	* @returns The number of final blocks (1 or 2)
+	*/
+	static size_t pad ( const sha256_midstate &midstate, unsigned char *blocks ) {
+		size_t count = midstate.buffered + 9 > 64 ? 2 : 1;
+		std::memset ( blocks, 0, 64 * count );
+		std::memcpy ( blocks, midstate.buffer, midstate.buffered );
+		blocks[midstate.buffered] = 0x80;
+
+		uint64_t bits = midstate.length * 8;
+		for ( int x = 0; x < 8; x++ )
+			blocks[64 * count - 1 - x] = (unsigned char)( bits >> ( 8 * x ) );
+
+		return count;
+	}
+
+	/**
+	* Writes a hashing state as a digest
+	*
+	* @param state - The 8 word hashing state
+	* @param digest - The buffer of SHA256_DIGEST_LENGTH bytes which recieves the digest
+	*/
+	static void store_digest ( const uint32_t *state, unsigned char *digest ) {
+		for ( int x = 0; x < 8; x++ )
+			store_be32 ( digest + 4 * x, state[x] );
+	}
+
+	/**
+	* Hashes a single message
+	*
+	* @param input - The message
+	* @param length - The length of the message
+	* @param digest - The buffer of SHA256_DIGEST_LENGTH bytes which recieves the digest
+	*/
+	void sha256_digest ( const unsigned char *input, size_t length, unsigned char *digest ) {
+		sha256_suffix ( sha256_prefix ( input, length ), NULL, 0, digest );
+	}
+
+	/**
+	* Hashes several independent messages at once
+	*
+	* @param inputs - The messages
+	* @param lengths - The length of each message
+	* @param count - The number of messages
+	* @param digests - The buffer of count * SHA256_DIGEST_LENGTH bytes which recieves the digests
+	*/
+	void sha256_many ( const unsigned char *const *inputs, const size_t *lengths, size_t count, unsigned char *digests ) {
+		sha256_many ( sha256_backend (), inputs, lengths, count, digests );
+	}
+
+	/**
+	* Hashes several independent messages at once with a given backend
+	*
+	* @param backend - The backend which should be used
+	* @param inputs - The messages
+	* @param lengths - The length of each message
+	* @param count - The number of messages
+	* @param digests - The buffer of count * SHA256_DIGEST_LENGTH bytes which recieves the digests
+	*/
+	void sha256_many ( Sha256Backend backend, const unsigned char *const *inputs, const size_t *lengths, size_t count, unsigned char *digests ) {
+		std::vector<uint32_t> states ( 8 * count );
+		std::vector<unsigned char> tails ( 128 * count );
+		std::vector<size_t> full_blocks ( count );
+		std::vector<size_t> total_blocks ( count );
+		size_t rounds = 0;
+
+		// Pads the tail of every message into its own final blocks
+		for ( size_t x = 0; x < count; x++ ) {
+			std::copy ( H0, H0 + 8, &states[8 * x] );
+			full_blocks[x] = lengths[x] / 64;
+
+			sha256_midstate tail;
+			std::memcpy ( tail.buffer, inputs[x] + 64 * full_blocks[x], lengths[x] % 64 );
+			tail.buffered = lengths[x] % 64;
+			tail.length = lengths[x];
+
+			total_blocks[x] = full_blocks[x] + pad ( tail, &tails[128 * x] );
+			rounds = std::max ( rounds, total_blocks[x] );
+		}
+
+		// Compresses the n-th block of every message which still has one, side by side
+		std::vector<uint32_t*> round_states;
+		std::vector<const unsigned char*> round_blocks;
+		for ( size_t round = 0; round < rounds; round++ ) {
+			round_states.clear ();
+			round_blocks.clear ();
+
+			for ( size_t x = 0; x < count; x++ ) {
+				if ( round >= total_blocks[x] )
+					continue;
+
+				round_states.push_back ( &states[8 * x] );
+				if ( round < full_blocks[x] )
+					round_blocks.push_back ( inputs[x] + 64 * round );
+				else
+					round_blocks.push_back ( &tails[128 * x + 64 * ( round - full_blocks[x] )] );
+			}
+
+			sha256_transform_many ( backend, round_states.data (), round_blocks.data (), round_states.size () );
+		}
+
+		for ( size_t x = 0; x < count; x++ )
+			store_digest ( &states[8 * x], digests + SHA256_DIGEST_LENGTH * x );
+	}
+
+	/**
+	* Hashes the constant prefix of a message, so that messages sharing it only
+	* need to hash their suffix
+	*
+	* @param prefix - The constant prefix
+	* @param length - The length of the prefix
+	* @returns The SHA256 state after absorbing the prefix
+	*/
+	sha256_midstate sha256_prefix ( const unsigned char *prefix, size_t length ) {
+		sha256_midstate midstate;
+		std::copy ( H0, H0 + 8, midstate.state );
+		midstate.buffered = 0;
+		midstate.length = 0;
+		update ( midstate, prefix, length );
+		return midstate;
+	}
+
+	/**
+	* Finishes hashing a message from the midstate of its prefix
+	*
+	* @param midstate - The state returned by sha256_prefix (left untouched)
+	* @param suffix - The rest of the message
+	* @param length - The length of the suffix
+	* @param digest - The buffer of SHA256_DIGEST_LENGTH bytes which recieves the raw digest
+	*/
+	void sha256_suffix ( sha256_midstate midstate, const unsigned char *suffix, size_t length, unsigned char *digest ) {
+		if ( length > 0 )
+			update ( midstate, suffix, length );
+
+		unsigned char blocks[128];
+		size_t count = pad ( midstate, blocks );
+		for ( size_t x = 0; x < count; x++ )
+			sha256_transform ( single_backend (), midstate.state, blocks + 64 * x );
+
+		store_digest ( midstate.state, digest );
+	}
+
+	/**
+	* Finishes hashing several messages which share the same prefix, side by side
+	* (This is what the miner uses, one suffix per candidate nonce)
+	*
+	* @param midstate - The state returned by sha256_prefix
+	* @param suffixes - The rest of each message
+	* @param length - The length of every suffix
+	* @param count - The number of suffixes
+	* @param digests - The buffer of count * SHA256_DIGEST_LENGTH bytes which recieves the digests
+	*/
+	void sha256_suffix_many ( const sha256_midstate &midstate, const unsigned char *const *suffixes, size_t length, size_t count, unsigned char *digests ) {
+
+		// Falls back to one message at a time unless each suffix fits in the final block
+		if ( midstate.buffered + length + 9 > 64 ) {
+			for ( size_t x = 0; x < count; x++ )
+				sha256_suffix ( midstate, suffixes[x], length, digests + SHA256_DIGEST_LENGTH * x );
+			return;
+		}
+
+		// Works through the suffixes in groups of 8 so that nothing is allocated
+		sha256_midstate tail = midstate;
+		tail.length += length;
+		tail.buffered = midstate.buffered + length;
+
+		for ( size_t group = 0; group < count; group += 8 ) {
+			size_t lanes = std::min ( count - group, (size_t) 8 );
+
+			uint32_t states[8][8];
+			unsigned char blocks[8][64];
+			uint32_t *state_pointers[8];
+			const unsigned char *block_pointers[8];
+
+			for ( size_t x = 0; x < lanes; x++ ) {
+				std::copy ( midstate.state, midstate.state + 8, states[x] );
+				std::memcpy ( tail.buffer + midstate.buffered, suffixes[group + x], length );
+				pad ( tail, blocks[x] );
+
+				state_pointers[x] = states[x];
+				block_pointers[x] = blocks[x];
+			}
+
+			sha256_transform_many ( sha256_backend (), state_pointers, block_pointers, lanes );
+
+			for ( size_t x = 0; x < lanes; x++ )
+				store_digest ( states[x], digests + SHA256_DIGEST_LENGTH * ( group + x ) );
+		}
+	}
+
+	/**
+	* Cross-checks a backend against OpenSSL on messages of every length up to a few blocks
+	*
+	* @param backend - The backend which should be checked
+	* @returns Whether or not every digest matched OpenSSL's
+	*/
+	bool sha256_self_test ( Sha256Backend backend ) {
+		if ( !sha256_supported ( backend ) )
+			return false;
+
+		// Builds messages of every length from 0 to 200 bytes
+		const size_t count = 201;
+		std::vector<unsigned char> data ( count );
+		for ( size_t x = 0; x < count; x++ )
+			data[x] = (unsigned char)( x * 131 + 7 );
+
+		std::vector<const unsigned char*> inputs ( count, data.data () );
+		std::vector<size_t> lengths ( count );
+		for ( size_t x = 0; x < count; x++ )
+			lengths[x] = x;
+
+		std::vector<unsigned char> digests ( SHA256_DIGEST_LENGTH * count );
+		sha256_many ( backend, inputs.data (), lengths.data (), count, digests.data () );
+
+		for ( size_t x = 0; x < count; x++ ) {
+			unsigned char expected[SHA256_DIGEST_LENGTH];
+			if ( EVP_Digest ( inputs[x], lengths[x], expected, NULL, EVP_sha256 (), NULL ) != 1 )
+				return false;
+
+			if ( std::memcmp ( expected, &digests[SHA256_DIGEST_LENGTH * x], SHA256_DIGEST_LENGTH ) != 0 )
+				return false;
+		}
+
+		return true;
+	}
+}
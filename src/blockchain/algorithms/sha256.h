@@ -0,0 +1,42 @@
+#pragma once
+#ifndef SHA256_H
+#define SHA256_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <stdexcept>
+#include <openssl/evp.h>
+#include <openssl/sha.h>
+
+namespace crypto {
+	enum class Sha256Backend { SCALAR, SSE4, AVX2, SHANI };
+
+	struct sha256_midstate {
+		uint32_t state[8];
+		unsigned char buffer[64];
+		size_t buffered;
+		uint64_t length;
+	};
+
+	Sha256Backend sha256_backend ();
+	bool sha256_supported ( Sha256Backend backend );
+	std::string sha256_backend_name ( Sha256Backend backend );
+
+	void sha256_transform ( Sha256Backend backend, uint32_t *state, const unsigned char *block );
+	void sha256_transform_many ( Sha256Backend backend, uint32_t *const *states, const unsigned char *const *blocks, size_t count );
+
+	void sha256_digest ( const unsigned char *input, size_t length, unsigned char *digest );
+	void sha256_many ( const unsigned char *const *inputs, const size_t *lengths, size_t count, unsigned char *digests );
+	void sha256_many ( Sha256Backend backend, const unsigned char *const *inputs, const size_t *lengths, size_t count, unsigned char *digests );
+
+	sha256_midstate sha256_prefix ( const unsigned char *prefix, size_t length );
+	void sha256_suffix ( sha256_midstate midstate, const unsigned char *suffix, size_t length, unsigned char *digest );
+	void sha256_suffix_many ( const sha256_midstate &midstate, const unsigned char *const *suffixes, size_t length, size_t count, unsigned char *digests );
+
+	bool sha256_self_test ( Sha256Backend backend );
+}
+
+#endif
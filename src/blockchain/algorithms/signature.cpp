@@ -0,0 +1,152 @@
+#include "signature.h"
+
+namespace crypto {
+
+	/**
+	* Signs a payload with a keypair through EVP
+	*
+	* @param keypair - The signer's keypair
+	* @param digest - The message digest (NULL for schemes which hash internally)
+	* @param payload - The data which should be signed
+	* @returns The raw signature
+	*/
+	static std::string evp_sign ( EVP_PKEY *keypair, const EVP_MD *digest, const std::string &payload ) {
+		std::unique_ptr<EVP_MD_CTX, decltype ( &EVP_MD_CTX_free )> context ( EVP_MD_CTX_new (), EVP_MD_CTX_free );
+		if ( !context || EVP_DigestSignInit ( context.get (), NULL, digest, NULL, keypair ) != 1 )
+			throw std::runtime_error ( "Failed to sign transaction output!" );
+
+		// Gets the signature size
+		size_t signature_length = 0;
+		if ( EVP_DigestSign ( context.get (), NULL, &signature_length, (const unsigned char*) payload.c_str (), payload.length () ) != 1 )
+			throw std::runtime_error ( "Failed to sign transaction output!" );
+
+		std::string signature ( signature_length, '\0' );
+		if ( EVP_DigestSign ( context.get (), (unsigned char*) &signature[0], &signature_length, (const unsigned char*) payload.c_str (), payload.length () ) != 1 )
+			throw std::runtime_error ( "Failed to sign transaction output!" );
+
+		signature.resize ( signature_length );
+		return signature;
+	}
+
+	/**
+	* Verifies a payload's signature through EVP
+	*
+	* @param public_key - The signer's public key
+	* @param digest - The message digest (NULL for schemes which hash internally)
+	* @param payload - The data which was signed
+	* @param signature - The raw signature
+	* @returns Whether or not the signature is valid
+	*/
+	static bool evp_verify ( EVP_PKEY *public_key, const EVP_MD *digest, const std::string &payload, const std::string &signature ) {
+		std::unique_ptr<EVP_MD_CTX, decltype ( &EVP_MD_CTX_free )> context ( EVP_MD_CTX_new (), EVP_MD_CTX_free );
+		if ( !context || EVP_DigestVerifyInit ( context.get (), NULL, digest, NULL, public_key ) != 1 )
+			throw std::runtime_error ( "Failed to verify transaction signature!" );
+
+		return EVP_DigestVerify ( context.get (), (const unsigned char*) signature.c_str (), signature.length (), (const unsigned char*) payload.c_str (), payload.length () ) == 1;
+	}
+
+	/**
+	* Creates an RSA scheme
+	*
+	* @param key_size - The length of generated keys in bits
+	* @returns The scheme
+	*/
+	std::shared_ptr<SignatureScheme> SignatureScheme::rsa ( int key_size ) {
+		return std::make_shared<RsaScheme> ( key_size );
+	}
+
+	/**
+	* Gets the Ed25519 scheme
+	*
+	* @returns The scheme
+	*/
+	std::shared_ptr<SignatureScheme> SignatureScheme::ed25519 () {
+		static std::shared_ptr<SignatureScheme> scheme = std::make_shared<Ed25519Scheme> ();
+		return scheme;
+	}
+
+	/**
+	* Gets the scheme which verifies signatures made with a given key
+	*
+	* @param key - The public key
+	* @returns The key's scheme
+	*/
+	std::shared_ptr<SignatureScheme> SignatureScheme::for_key ( EVP_PKEY *key ) {
+		switch ( EVP_PKEY_get_base_id ( key ) ) {
+			case EVP_PKEY_ED25519:
+				return ed25519 ();
+
+			case EVP_PKEY_RSA: {
+				static std::shared_ptr<SignatureScheme> scheme = std::make_shared<RsaScheme> ( 0 );
+				return scheme;
+			}
+
+			default:
+				throw std::runtime_error ( "Unsupported public key type!" );
+		}
+	}
+
+	/**
+	* The RSA scheme constructor
+	*
+	* @param key_size - The length of generated keys in bits (recommended 4096 bits)
+	*/
+	RsaScheme::RsaScheme ( int key_size ) {
+		this -> key_size = key_size;
+	}
+
+	std::string RsaScheme::name () const {
+		return "RSA-" + std::to_string ( this -> key_size );
+	}
+
+	/**
+	* Generates a new RSA keypair
+	*
+	* @returns The keypair
+	*/
+	EVP_PKEY *RsaScheme::generate_keypair () const {
+		std::unique_ptr<EVP_PKEY_CTX, decltype ( &EVP_PKEY_CTX_free )> context ( EVP_PKEY_CTX_new_id ( EVP_PKEY_RSA, NULL ), EVP_PKEY_CTX_free );
+
+		// Generates the keypair with the default public exponent (65537)
+		EVP_PKEY *keypair = NULL;
+		if ( !context || EVP_PKEY_keygen_init ( context.get () ) != 1 || EVP_PKEY_CTX_set_rsa_keygen_bits ( context.get (), this -> key_size ) != 1 || EVP_PKEY_keygen ( context.get (), &keypair ) != 1 )
+			throw std::runtime_error ( "Failed to generate the RSA keypair!" );
+
+		return keypair;
+	}
+
+	std::string RsaScheme::sign ( EVP_PKEY *keypair, const std::string &payload ) const {
+		return evp_sign ( keypair, EVP_sha256 (), payload );
+	}
+
+	bool RsaScheme::verify ( EVP_PKEY *public_key, const std::string &payload, const std::string &signature ) const {
+		return evp_verify ( public_key, EVP_sha256 (), payload, signature );
+	}
+
+	std::string Ed25519Scheme::name () const {
+		return "Ed25519";
+	}
+
+	/**
+	* Generates a new Ed25519 keypair
+	*
+	* @returns The keypair
+	*/
+	EVP_PKEY *Ed25519Scheme::generate_keypair () const {
+		std::unique_ptr<EVP_PKEY_CTX, decltype ( &EVP_PKEY_CTX_free )> context ( EVP_PKEY_CTX_new_id ( EVP_PKEY_ED25519, NULL ), EVP_PKEY_CTX_free );
+
+		EVP_PKEY *keypair = NULL;
+		if ( !context || EVP_PKEY_keygen_init ( context.get () ) != 1 || EVP_PKEY_keygen ( context.get (), &keypair ) != 1 )
+			throw std::runtime_error ( "Failed to generate the Ed25519 keypair!" );
+
+		return keypair;
+	}
+
+	std::string Ed25519Scheme::sign ( EVP_PKEY *keypair, const std::string &payload ) const {
+		return evp_sign ( keypair, NULL, payload );
+	}
+
+	bool Ed25519Scheme::verify ( EVP_PKEY *public_key, const std::string &payload, const std::string &signature ) const {
+		return evp_verify ( public_key, NULL, payload, signature );
+	}
+}
@@ -0,0 +1,58 @@
+#pragma once
+#ifndef SIGNATURE_H
+#define SIGNATURE_H
+
+#include <string>
+#include <memory>
+#include <stdexcept>
+#include <openssl/evp.h>
+#include <openssl/rsa.h>
+
+namespace crypto {
+
+	/**
+	 * A digital signature algorithm, used to generate keypairs and to sign and verify payloads
+	 */
+	class SignatureScheme {
+		public:
+			virtual ~SignatureScheme () = default;
+
+			virtual std::string name () const = 0;
+			virtual EVP_PKEY *generate_keypair () const = 0;
+			virtual std::string sign ( EVP_PKEY *keypair, const std::string &payload ) const = 0;
+			virtual bool verify ( EVP_PKEY *public_key, const std::string &payload, const std::string &signature ) const = 0;
+
+			static std::shared_ptr<SignatureScheme> rsa ( int key_size );
+			static std::shared_ptr<SignatureScheme> ed25519 ();
+			static std::shared_ptr<SignatureScheme> for_key ( EVP_PKEY *key );
+	};
+
+	/**
+	 * RSA signatures over a SHA256 digest
+	 */
+	class RsaScheme : public SignatureScheme {
+		public:
+			RsaScheme ( int key_size );
+
+			std::string name () const override;
+			EVP_PKEY *generate_keypair () const override;
+			std::string sign ( EVP_PKEY *keypair, const std::string &payload ) const override;
+			bool verify ( EVP_PKEY *public_key, const std::string &payload, const std::string &signature ) const override;
+
+		private:
+			int key_size;
+	};
+
+	/**
+	 * Ed25519 signatures (32 byte public keys, 64 byte signatures)
+	 */
+	class Ed25519Scheme : public SignatureScheme {
+		public:
+			std::string name () const override;
+			EVP_PKEY *generate_keypair () const override;
+			std::string sign ( EVP_PKEY *keypair, const std::string &payload ) const override;
+			bool verify ( EVP_PKEY *public_key, const std::string &payload, const std::string &signature ) const override;
+	};
+}
+
+#endif
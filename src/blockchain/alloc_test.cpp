@@ -0,0 +1,114 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <memory_resource>
+#include "wallet.h"
+#include "block.h"
+#include "blockchain.h"
+#include "transaction.h"
+
+/**
+ * Counts the allocations made through it, passing them on to the heap
+ * (Installed as the default resource, it sees every buffer a transaction
+ * owns: its inputs, its outputs and their signatures)
+ */
+class CountingResource : public std::pmr::memory_resource {
+	public:
+		uint64_t allocations = 0;
+
+	private:
+		void *do_allocate ( size_t bytes, size_t alignment ) override {
+			this -> allocations++;
+			return std::pmr::new_delete_resource () -> allocate ( bytes, alignment );
+		}
+
+		void do_deallocate ( void *memory, size_t bytes, size_t alignment ) override {
+			std::pmr::new_delete_resource () -> deallocate ( memory, bytes, alignment );
+		}
+
+		bool do_is_equal ( const std::pmr::memory_resource &other ) const noexcept override {
+			return this == &other;
+		}
+};
+
+static int failures = 0;
+
+/**
+ * Reports a failed check
+ *
+ * @param condition - The checked condition
+ * @param message - What was checked
+ */
+static void check ( bool condition, const std::string &message ) {
+	if ( condition )
+		return;
+
+	std::cout << "FAILED: " << message << std::endl;
+	failures++;
+}
+
+/**
+ * Checks that transactions are moved, never deep copied, from the wallet into a mined block
+ * (A deep copy allocates at least four buffers per transaction, so the
+ * submit path must allocate nothing, and accepting a peer's block or mining
+ * fewer buffers than there are pooled transactions, which only leaves room
+ * for the block's own lists)
+ */
+int main () {
+	CountingResource counter;
+	std::pmr::set_default_resource ( &counter );
+
+	const size_t count = 64;
+	Wallet walletA ( crypto::SignatureScheme::ed25519 () );
+	Wallet walletB ( crypto::SignatureScheme::ed25519 () );
+	Blockchain chain ( 1, 69, walletA.create_coinbase ( walletA.public_key, 69 ), 1 );
+
+	// Gives the wallet one output per transaction
+	for ( size_t block = 1; block < count; block++ )
+		chain.mine_block ( walletA.create_coinbase ( walletA.public_key, 69 ) );
+
+	walletA.sync ( chain );
+
+	// Follows the chain from a peer, which mines a block of its own on the same tip
+	Blockchain peer ( chain.get_block ( 0 ), 1, 69, 1 );
+	for ( size_t height = 1; height < chain.height (); height++ )
+		peer.accept_block ( chain.get_block ( height ) );
+
+	peer.mine_block ( walletA.create_coinbase ( walletA.public_key, 69 ) );
+	Block extension = peer.get_block ( peer.height () - 1 );
+
+	std::vector<Transaction> transactions;
+	for ( size_t x = 0; x < count; x++ )
+		transactions.push_back ( walletA.create_transaction ( walletB.public_key, 1 ) );
+
+	Transaction coinbase = walletA.create_coinbase ( walletA.public_key, 69 );
+
+	counter.allocations = 0;
+	for ( auto &transaction : transactions )
+		chain.add_transaction ( std::move ( transaction ) );
+
+	uint64_t submitted = counter.allocations;
+	check ( submitted == 0, "submitting transactions allocates nothing, " + std::to_string ( submitted ) + " allocations" );
+
+	// Accepting a block which extends the tip leaves the pool alone
+	counter.allocations = 0;
+	chain.accept_block ( std::move ( extension ) );
+
+	uint64_t accepted = counter.allocations;
+	check ( accepted < count && chain.mempool.size () == count, "accepting a block copies no pooled transaction, " + std::to_string ( accepted ) + " allocations for " + std::to_string ( count ) + " transactions" );
+
+	counter.allocations = 0;
+	chain.mine_block ( std::move ( coinbase ) );
+
+	uint64_t mined = counter.allocations;
+	check ( mined < count, "mining copies no transaction, " + std::to_string ( mined ) + " allocations for " + std::to_string ( count ) + " transactions" );
+
+	walletB.sync ( chain );
+	check ( walletB.calculate_balance () == (long) count, "every transaction is mined" );
+
+	std::pmr::set_default_resource ( nullptr );
+
+	std::cout << ( failures == 0 ? "All allocation checks passed" : std::to_string ( failures ) + " allocation checks failed" ) << " (submit: " << submitted << ", accept: " << accepted << ", mine: " << mined << ")" << std::endl;
+	return failures == 0 ? 0 : 1;
+}
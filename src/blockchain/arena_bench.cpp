@@ -0,0 +1,152 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <string>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <algorithm>
+#include <memory_resource>
+#include "wallet.h"
+#include "block.h"
+#include "blockchain.h"
+#include "transaction.h"
+
+static std::atomic<uint64_t> allocations { 0 };
+
+/**
+ * Counts every heap allocation made by the benchmark
+ * (pmr containers on the default resource allocate through the aligned
+ * overloads, so those are counted too)
+ */
+void *operator new ( size_t size ) {
+	allocations++;
+	if ( void *memory = std::malloc ( size == 0 ? 1 : size ) )
+		return memory;
+
+	throw std::bad_alloc ();
+}
+
+void *operator new ( size_t size, std::align_val_t alignment ) {
+	allocations++;
+	size_t align = std::max ( (size_t) alignment, sizeof ( void* ) );
+	if ( void *memory = std::aligned_alloc ( align, ( std::max<size_t> ( size, 1 ) + align - 1 ) / align * align ) )
+		return memory;
+
+	throw std::bad_alloc ();
+}
+
+void operator delete ( void *memory ) noexcept {
+	std::free ( memory );
+}
+
+void operator delete ( void *memory, size_t ) noexcept {
+	std::free ( memory );
+}
+
+void operator delete ( void *memory, std::align_val_t ) noexcept {
+	std::free ( memory );
+}
+
+void operator delete ( void *memory, size_t, std::align_val_t ) noexcept {
+	std::free ( memory );
+}
+
+struct Result {
+	double time;
+	double allocations;
+};
+
+/**
+ * Times a callable and counts its heap allocations, averaged over several runs
+ *
+ * @param runs - The number of runs
+ * @param run - The callable
+ * @returns The mean time of one run in milliseconds, and its mean allocation count
+ */
+template <typename Run>
+static Result measure ( int runs, Run run ) {
+	uint64_t before = allocations;
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now ();
+	for ( int x = 0; x < runs; x++ )
+		run ();
+
+	double time = std::chrono::duration<double, std::milli> ( std::chrono::steady_clock::now () - start ).count () / runs;
+	return Result { time, (double) ( allocations - before ) / runs };
+}
+
+/**
+ * Prints one benchmark row
+ *
+ * @param name - What was measured
+ * @param heap - The measurement on the default allocator
+ * @param arena - The measurement on a monotonic arena
+ */
+static void report ( const std::string &name, Result heap, Result arena ) {
+	std::cout << std::left << std::setw ( 22 ) << name << std::right << std::fixed << std::setprecision ( 0 ) << std::setw ( 14 ) << heap.allocations << std::setw ( 14 ) << arena.allocations << std::setprecision ( 2 ) << std::setw ( 12 ) << heap.time << std::setw ( 12 ) << arena.time << std::endl;
+}
+
+/**
+ * Benchmarks decoding and assembling blocks on the default allocator against a monotonic arena
+ * (Run with the number of transactions per block, 2000 by default, and a
+ * number to scale the iteration counts. Every run also destroys the block,
+ * which the arena does in one release. Assembling still allocates on the
+ * heap to verify each transaction)
+ */
+int main ( int argc, char **argv ) {
+	size_t count = argc > 1 ? std::max ( std::atoi ( argv[1] ), 1 ) : 2000;
+	int scale = argc > 2 ? std::max ( std::atoi ( argv[2] ), 1 ) : 1;
+	int runs = std::max<int> ( 1, 20000 / (int) count ) * scale;
+
+	// Signs one transaction, which every block repeats
+	Wallet walletA ( crypto::SignatureScheme::ed25519 () );
+	Wallet walletB ( crypto::SignatureScheme::ed25519 () );
+	Blockchain chain ( 1, 69, walletA.create_coinbase ( walletA.public_key, 69 ), 1 );
+	walletA.sync ( chain );
+	Transaction transaction = walletA.create_transaction ( walletB.public_key, 1 );
+	Transaction coinbase = walletA.create_coinbase ( walletA.public_key, 69 );
+
+	Block block ( Hash256 {}, 0, 1 );
+	block.set_coinbase ( coinbase );
+	std::vector<Transaction> transactions ( count, transaction );
+	block.add_transactions ( transactions, 1 );
+	block.mine_block ( 1 );
+
+	std::string bytes = block.to_bytes ();
+	serialize::Span span { reinterpret_cast<const unsigned char*> ( bytes.data () ), bytes.size () };
+	std::pmr::monotonic_buffer_resource arena;
+
+	std::cout << count << " transactions per block, " << bytes.size () << " bytes" << std::endl;
+	std::cout << std::left << std::setw ( 22 ) << "" << std::right << std::setw ( 14 ) << "heap allocs" << std::setw ( 14 ) << "arena allocs" << std::setw ( 12 ) << "heap (ms)" << std::setw ( 12 ) << "arena (ms)" << std::endl;
+
+	report ( "decode",
+		measure ( runs, [&] () { Block::decode ( span ); } ),
+		measure ( runs, [&] () {
+			{ Block decoded = Block::decode ( span, &arena ); }
+			arena.release ();
+		} )
+	);
+
+	// Builds a block out of copies taken straight onto the block's allocator
+	auto assemble = [&] ( Block &assembled ) {
+		assembled = Block ( Hash256 {}, 0, 1 );
+		assembled.set_coinbase ( coinbase );
+		for ( size_t x = 0; x < count; x++ )
+			assembled.add_transaction ( Transaction ( transaction, assembled.transactions.get_allocator () ) );
+	};
+
+	report ( "assemble",
+		measure ( runs, [&] () {
+			Block assembled;
+			assemble ( assembled );
+		} ),
+		measure ( runs, [&] () {
+			{
+				Block assembled { Block::allocator_type ( &arena ) };
+				assemble ( assembled );
+			}
+			arena.release ();
+		} )
+	);
+}
@@ -8,13 +8,15 @@
  * @param coinbase - The coinbase transaction which contains the miner reward
  * @param difficulty - The block's mining difficulty
  */
-Block::Block ( std::string prev_block, long index, Transaction coinbase, int difficulty ) {
+Block::Block ( Hash256 prev_block, long index, Transaction coinbase, int difficulty ) {
 	this -> prev_block = prev_block;
 	this -> index = index;
 	this -> nonce = 0;
 	this -> difficulty = difficulty;
-	this -> transactions.push_back ( coinbase );
 	this -> set_timestamp ();
+	this -> has_coinbase = false;
+	this -> tree.append ( Hash256 {} );
+	this -> set_coinbase ( coinbase );
 	this -> calculate_merkel_tree ();
 	this -> calculate_hash ();
 }
@@ -26,38 +28,105 @@ Block::Block ( std::string prev_block, long index, Transaction coinbase, int dif
  * @param index - The block's index
  * @param difficulty - The block's mining difficulty
  */
-Block::Block ( std::string prev_block, long index, int difficulty ) {
+Block::Block ( Hash256 prev_block, long index, int difficulty ) {
 	this -> prev_block = prev_block;
+	this -> merkel_tree = Hash256 {};
 	this -> index = index;
 	this -> nonce = 0;
 	this -> difficulty = difficulty;
 	this -> set_timestamp ();
+	this -> has_coinbase = false;
+
+	// Reserves the coinbase's leaf
+	this -> tree.append ( Hash256 {} );
 	this -> calculate_merkel_tree ();
 	this -> calculate_hash ();
 }
 
-Block::Block () {}
+Block::Block () {
+	this -> has_coinbase = false;
+}
+
+/**
+ * The arena constructor
+ * (Every transaction added to the block, and everything they own, is stored
+ * by the allocator, which must outlive the block)
+ *
+ * @param allocator - Where the block's transactions are stored
+ */
+Block::Block ( const allocator_type &allocator ): transactions ( allocator ) {
+	this -> has_coinbase = false;
+}
+
+/**
+ * Adds a copy of a transaction to the block
+ *
+ * @param transaction - The transaction which should be added to the block
+ */ 
+void Block::add_transaction ( const Transaction &transaction ) {
+	this -> add_transaction ( Transaction ( transaction ) );
+}
 
 /**
- * Adds a transaction to the block
+ * Moves a transaction into the block
+ * (Only updates the transaction's path in the merkel tree, the root and the
+ * block's hash are refreshed when the block is mined. The transaction is
+ * left untouched if it's rejected)
  *
  * @param transaction - The transaction which should be added to the block
  */ 
-void Block::add_transaction ( Transaction transaction ) {
+void Block::add_transaction ( Transaction &&transaction ) {
 
 	// Verifies the transaction
 	if ( !( transaction.verify ( false ) ) )
 		throw std::runtime_error ( "Attempted adding an invalid transaction to the block!" );
 
-	// Pushes the transaction
-	transaction.set_index ( this -> index + this -> transactions.size () + 1 );
-	this -> transactions.push_back ( transaction );
+	// Pushes the transaction (position 0 is always reserved for the coinbase)
+	transaction.set_index ( this -> index + this -> transactions.size () + ( this -> has_coinbase ? 0 : 1 ) );
+	this -> tree.append ( transaction.hash );
+	this -> transactions.push_back ( std::move ( transaction ) );
+}
+
+/**
+ * Moves a batch of transactions into the block
+ * (The transactions are verified in parallel, then indexed in one pass; the
+ * merkel tree is extended once and the root and the block's hash are
+ * refreshed at the end. Rejected transactions are left untouched)
+ *
+ * @param transactions - The transactions which should be added to the block
+ * @param threads - The number of threads used to verify them (0 uses every available core)
+ * @returns Whether or not each transaction was added
+ */
+std::vector<bool> Block::add_transactions ( std::vector<Transaction> &transactions, unsigned int threads ) {
+	std::vector<char> valid ( transactions.size (), 0 );
+	parallel::for_each ( transactions.size (), threads, [&transactions, &valid] ( size_t x ) {
+		try {
+			valid[x] = transactions[x].verify ( false );
+		} catch ( const std::runtime_error & ) {}
+	} );
+
+	// Pushes the transactions (position 0 is always reserved for the coinbase)
+	std::vector<bool> added ( transactions.size (), false );
+	std::vector<Hash256> leaves;
+	long tx_index = this -> index + this -> transactions.size () + ( this -> has_coinbase ? 0 : 1 );
+	for ( size_t x = 0; x < transactions.size (); x++ ) {
+		if ( !( valid[x] ) )
+			continue;
+
+		transactions[x].set_index ( tx_index++ );
+		leaves.push_back ( transactions[x].hash );
+		this -> transactions.push_back ( std::move ( transactions[x] ) );
+		added[x] = true;
+	}
+
+	this -> tree.append ( leaves );
 	this -> calculate_merkel_tree ();
 	this -> calculate_hash ();
+	return added;
 }
 
 /**
- * Sets the block's coinbase
+ * Sets or replaces the block's coinbase
  *
  * @param coinbase - The block's new coinbase
  */
@@ -69,38 +138,44 @@ void Block::set_coinbase ( Transaction coinbase ) {
 
 	// Adds the coinbase 
 	coinbase.set_index ( this -> index );
-	this -> transactions.insert ( this -> transactions.begin (), coinbase );
-	this -> calculate_merkel_tree ();
-	this -> calculate_hash ();
+	this -> tree.replace ( 0, coinbase.hash );
+
+	if ( this -> has_coinbase )
+		this -> transactions.front () = std::move ( coinbase );
+	else
+		this -> transactions.insert ( this -> transactions.begin (), std::move ( coinbase ) );
+
+	this -> has_coinbase = true;
 }
 
 /**
  * Calculates the block's hash
  */
 void Block::calculate_hash () {
-	this -> hash = crypto::sha256 ( this -> to_string ( true ) );
+	unsigned char header[HEADER_SIZE];
+	this -> to_header ( header );
+	this -> hash = crypto::sha256 ( header, HEADER_SIZE );
 }
 
 /**
- * Calculates the block transaction's merkel tree
+ * Materializes the block transaction's merkel tree root
  */
 void Block::calculate_merkel_tree () {
-	if ( this -> transactions.size () > 0 ) {
-
-		// Calculates the merkel tree
-		std::vector<std::string> tree;
-		for ( std::vector<Transaction>::iterator transaction = this -> transactions.begin (); transaction < this -> transactions.end (); transaction += 2 ) {
-
-			std::string raw ( transaction -> to_string () );
-
-			if ( ( transaction + 1 ) != this -> transactions.end () )
-				raw.append ( ( transaction + 1 ) -> to_string () );
+	this -> merkel_tree = this -> tree.root ();
+}
 
-			tree.push_back ( crypto::sha256 ( raw ) ); 
-		}
+/**
+ * Builds a proof that a transaction is part of the block, which can be checked
+ * against the block's merkel root with MerkleTree::verify_proof
+ *
+ * @param tx_index - The index of the transaction
+ * @returns The transaction's inclusion proof
+ */
+MerkleProof Block::merkle_proof ( long tx_index ) {
+	if ( tx_index < this -> index || tx_index - this -> index >= (long) this -> transactions.size () )
+		throw std::runtime_error ( "The transaction isn't in this block!" );
 
-		this -> merkel_tree = crypto::merkel_tree ( tree ); 
-	}
+	return this -> tree.proof ( tx_index - this -> index );
 }
 
 /**
@@ -109,11 +184,14 @@ void Block::calculate_merkel_tree () {
  * @returns Whether or not the block's hash is valid
  */
 bool Block::verify_hash () {
-	return this -> hash == crypto::sha256 ( this -> to_string ( true ) );
+	unsigned char header[HEADER_SIZE];
+	this -> to_header ( header );
+	return this -> hash == crypto::sha256 ( header, HEADER_SIZE );
 }
 
 /**
  * Verifies the block's merkel tree
+ * (Rebuilds the tree from each transaction's content, not from the cached leaves)
  *
  * @returns Whether or not the block's merkel tree is valid
  */
@@ -121,19 +199,12 @@ bool Block::verify_merkel_tree () {
 	if ( this -> transactions.size () == 0 )
 		return false;
 	
-	// Loops through the transactions
-	std::vector<std::string> tree;
-	for ( std::vector<Transaction>::iterator transaction = this -> transactions.begin (); transaction < this -> transactions.end (); transaction += 2 ) {
-
-		std::string raw ( transaction -> to_string () );
-
-		if ( ( transaction + 1 ) != this -> transactions.end () )
-			raw.append ( ( transaction + 1 ) -> to_string () );
-
-		tree.push_back ( crypto::sha256 ( raw ) ); 
-	}
+	// Rehashes every transaction in one batch
+	std::vector<std::string> leaves;
+	for ( std::pmr::vector<Transaction>::iterator transaction = this -> transactions.begin (); transaction < this -> transactions.end (); transaction++ )
+		leaves.push_back ( transaction -> to_bytes () );
 	
-	return this -> merkel_tree == crypto::merkel_tree ( tree );
+	return this -> merkel_tree == crypto::merkel_tree ( crypto::sha256_many ( leaves ) );
 }
 
 /**
@@ -148,7 +219,7 @@ bool Block::verify_transactions () {
 
 	// Loops through each transaction
 	if ( this -> transactions.size () > 1 )
-		for ( std::vector<Transaction>::iterator transaction = this -> transactions.begin () + 1; transaction < this -> transactions.end (); transaction++ ) {
+		for ( std::pmr::vector<Transaction>::iterator transaction = this -> transactions.begin () + 1; transaction < this -> transactions.end (); transaction++ ) {
 
 			// Verifies the integrity of the transaction
 			if ( !( transaction -> verify ( false ) ) )
@@ -164,6 +235,32 @@ bool Block::verify_transactions () {
 	return true;
 }
 
+/**
+ * Verifies each transaction in the block (including the coinbase) across several threads
+ * (Every signature in the block is checked independently first, then the rest
+ * of each transaction, with the first failure stopping every worker)
+ *
+ * @param threads - The number of worker threads (0 uses every available core)
+ * @returns Whether or not every trasaction in the block is valid
+ */
+bool Block::verify_transactions ( unsigned int threads ) {
+
+	if ( parallel::resolve_threads ( threads ) <= 1 )
+		return this -> verify_transactions ();
+
+	if ( this -> transactions.size () == 0 )
+		return false;
+
+	if ( !( this -> verify_signatures ( threads ) ) )
+		return false;
+
+	// Verifies the rest of every transaction
+	return parallel::all_of ( this -> transactions.size () - 1, threads, [this] ( size_t x ) {
+		Transaction &transaction = this -> transactions[x + 1];
+		return transaction.verify ( false, false ) && transaction.tx_index == (long int)( this -> index + x + 1 );
+	} );
+}
+
 /**
  * Verifies the block's coinbase transactions
  *
@@ -174,7 +271,7 @@ bool Block::verify_coinbase ( long reward ) {
 
 	// Calculates the coinbase's input total
 	long total = 0;
-	for ( auto input : this -> transactions.begin () -> inputs )
+	for ( auto &input : this -> transactions.begin () -> inputs )
 		total += input.prev_out.value;
 
 	if ( reward != total )
@@ -209,7 +306,7 @@ bool Block::verify ( bool is_genesis ) {
 	if ( this -> difficulty <= 0 )
 		return false;
 
-	if ( !is_genesis && this -> prev_block.empty () )
+	if ( !is_genesis && this -> prev_block.is_zero () )
 		return false;
 
 	if ( !is_genesis && this -> index == 0 )
@@ -230,6 +327,18 @@ bool Block::verify ( bool is_genesis ) {
  * @returns Whether or not the block is valid
  */
 bool Block::verify ( bool is_genesis, long reward ) {
+	return this -> verify ( is_genesis, reward, 1 );
+}
+
+/**
+ * Verifies the block, checking its transactions across several threads
+ *
+ * @param is_genesis - If the block is a genesis block
+ * @param reward - The block's mining reward
+ * @param threads - The number of threads used to verify the transactions
+ * @returns Whether or not the block is valid
+ */
+bool Block::verify ( bool is_genesis, long reward, unsigned int threads ) {
 
 	// Verifies the block's hash
 	if ( !( this -> verify_hash () ) )
@@ -240,7 +349,7 @@ bool Block::verify ( bool is_genesis, long reward ) {
 		return false;
 
 	// Verifies the transactions in the block
-	if ( !( this -> verify_transactions () ) )
+	if ( !( this -> verify_transactions ( threads ) ) )
 		return false;
 
 	// Verifies the coinbase
@@ -250,7 +359,7 @@ bool Block::verify ( bool is_genesis, long reward ) {
 	if ( this -> difficulty <= 0 )
 		return false;
 
-	if ( !is_genesis && this -> prev_block.empty () )
+	if ( !is_genesis && this -> prev_block.is_zero () )
 		return false;
 
 	if ( !is_genesis && this -> index == 0 )
@@ -263,32 +372,363 @@ bool Block::verify ( bool is_genesis, long reward ) {
 }
 
 /**
- * Converts the block to a string
+ * Verifies everything about the block except its signatures
+ * (Used for blocks which are assumed to be valid, so every hash, the merkel
+ * tree, the proof of work and the coinbase reward are still checked)
  *
- * @param is_hash - Whether or not this should include the block's current hash
+ * @param is_genesis - If the block is a genesis block
+ * @param reward - The block's mining reward
+ * @returns Whether or not the block is structurally valid
  */
-std::string Block::to_string ( bool is_hash ) {
-	std::ostringstream stream;
+bool Block::verify_structure ( bool is_genesis, long reward ) {
+	return this -> verify_header ( is_genesis, reward ) && this -> verify_merkel_tree ();
+}
 
-	if ( !is_hash )
-		stream << this -> hash;
-	
-	stream << this -> prev_block;
-	stream << this -> merkel_tree;
-	stream << this -> time.count ();
-	stream << this -> nonce;
-	stream << this -> index;
-	return stream.str ();
+/**
+ * Runs the checks which don't need to hash any transaction
+ * (The header hash, the proof of work, the links and the coinbase reward, so
+ * that a bogus block is rejected before any of its transactions are hashed)
+ *
+ * @param is_genesis - If the block is a genesis block
+ * @param reward - The block's mining reward
+ * @returns Whether or not the block's header is valid
+ */
+bool Block::verify_header ( bool is_genesis, long reward ) {
+
+	if ( this -> transactions.size () == 0 )
+		return false;
+
+	// Verifies the block's hash
+	if ( !( this -> verify_hash () ) )
+		return false;
+
+	// Verifies the coinbase reward
+	long total = 0;
+	for ( auto &input : this -> transactions.front ().inputs )
+		total += input.prev_out.value;
+
+	if ( reward != total )
+		return false;
+
+	if ( this -> difficulty <= 0 )
+		return false;
+
+	if ( !is_genesis && this -> prev_block.is_zero () )
+		return false;
+
+	if ( !is_genesis && this -> index == 0 )
+		return false;
+
+	if ( !( this -> is_mined () ) )
+		return false;
+
+	return true;
+}
+
+/**
+ * Verifies every signature in the block on the calling thread
+ *
+ * @returns Whether or not every signature is valid
+ */
+bool Block::verify_signatures () {
+	for ( size_t position = 1; position < this -> transactions.size (); position++ )
+		if ( !( this -> transactions[position].verify_signatures () ) )
+			return false;
+
+	return true;
+}
+
+/**
+ * Verifies every signature in the block across several threads
+ * (Each signature is checked independently, with the first failure stopping every worker)
+ *
+ * @param threads - The number of worker threads (0 uses every available core)
+ * @returns Whether or not every signature is valid
+ */
+bool Block::verify_signatures ( unsigned int threads ) {
+	if ( parallel::resolve_threads ( threads ) <= 1 )
+		return this -> verify_signatures ();
+
+	// Collects every signature in the block
+	std::vector<TransactionOutput*> signatures;
+	for ( std::pmr::vector<Transaction>::iterator transaction = this -> transactions.begin () + 1; transaction < this -> transactions.end (); transaction++ ) {
+		for ( auto &input : transaction -> inputs )
+			signatures.push_back ( &input.prev_out );
+
+		for ( auto &output : transaction -> outputs )
+			signatures.push_back ( &output );
+	}
+
+	return parallel::all_of ( signatures.size (), threads, [&signatures] ( size_t x ) { return signatures[x] -> verify_signature (); } );
+}
+
+/**
+ * Gets every key which signed an output in the block, or an output it spends
+ * (In order of first appearance, so every node encodes a block identically)
+ *
+ * @returns The authors' handles
+ */
+std::vector<KeyTable::Handle> Block::signing_keys () {
+	std::vector<KeyTable::Handle> keys;
+	std::unordered_set<KeyTable::Handle> seen { KeyTable::NONE };
+
+	for ( auto &transaction : this -> transactions ) {
+		for ( auto &input : transaction.inputs )
+			if ( seen.insert ( input.prev_out.author ).second )
+				keys.push_back ( input.prev_out.author );
+
+		for ( auto &output : transaction.outputs )
+			if ( seen.insert ( output.author ).second )
+				keys.push_back ( output.author );
+	}
+
+	return keys;
+}
+
+/**
+ * Writes the block's binary encoding
+ * (version | hash | header | difficulty | transactions | keys, where every
+ * transaction is length prefixed so that views can skip over them; outputs
+ * only carry key IDs, so the PEM of every signing key is shipped once per
+ * block after the transactions)
+ *
+ * @param writer - The writer which recieves the encoding
+ */
+void Block::encode ( serialize::Writer &writer ) {
+	unsigned char header[HEADER_SIZE];
+	this -> to_header ( header );
+
+	writer.u8 ( serialize::VERSION );
+	writer.hash ( this -> hash );
+	writer.raw ( header, HEADER_SIZE );
+	writer.u32 ( (uint32_t) this -> difficulty );
+
+	writer.u32 ( this -> transactions.size () );
+	for ( auto &transaction : this -> transactions ) {
+		size_t length = writer.begin_length ();
+		transaction.encode ( writer );
+		writer.end_length ( length );
+	}
+
+	std::vector<KeyTable::Handle> keys = this -> signing_keys ();
+	writer.u32 ( keys.size () );
+	for ( auto key : keys ) {
+		std::string pem = KeyTable::global ().pem ( key );
+		if ( pem.empty () )
+			throw std::runtime_error ( "Attempted encoding a block signed by an unknown key!" );
+
+		writer.bytes ( pem );
+	}
+}
+
+/**
+ * Encodes the block
+ *
+ * @returns The block's binary encoding
+ */
+std::string Block::to_bytes () {
+	return serialize::to_bytes ( [&] ( serialize::Writer &writer ) { this -> encode ( writer ); } );
+}
+
+/**
+ * Reads a block written by encode
+ * (The stored hash is kept as is, verify_hash checks it against the header;
+ * the shipped keys are only readable while the block lives, until intern_keys
+ * is called once the block has been validated)
+ *
+ * @param bytes - Exactly the block's encoding
+ * @param allocator - Where the block's transactions are stored (e.g. an arena
+ * released once the block has been checked)
+ * @returns The decoded block
+ */
+Block Block::decode ( serialize::Span bytes, const allocator_type &allocator ) {
+	serialize::Reader reader ( bytes );
+	reader.version ();
+
+	Block block ( allocator );
+	block.hash = reader.hash ();
+	block.prev_block = reader.hash ();
+	block.merkel_tree = reader.hash ();
+	block.time = std::chrono::milliseconds ( reader.i64 () );
+	block.index = reader.i64 ();
+	block.nonce = reader.i64 ();
+	block.difficulty = (int) reader.u32 ();
+
+	uint32_t transactions = reader.u32 ();
+	block.transactions.reserve ( std::min<size_t> ( transactions, reader.remaining () / 4 ) );
+	for ( uint32_t x = 0; x < transactions; x++ ) {
+		block.transactions.push_back ( Transaction::decode ( reader.bytes (), allocator ) );
+		block.tree.append ( block.transactions.back ().hash );
+	}
+
+	uint32_t keys = reader.u32 ();
+	if ( keys > 0 )
+		block.shipped_keys = std::make_shared<KeyTable::Scope> ( KeyTable::global () );
+
+	for ( uint32_t x = 0; x < keys; x++ )
+		block.shipped_keys -> add ( reader.bytes ().to_string () );
+
+	if ( reader.remaining () != 0 )
+		throw std::runtime_error ( "Trailing bytes after serialized block!" );
+
+	block.has_coinbase = !block.transactions.empty ();
+	return block;
+}
+
+/**
+ * Adds the keys shipped with a decoded block to the key table for good
+ * (Called once the block has been validated, so rejected blocks leave nothing behind)
+ */
+void Block::intern_keys () {
+	if ( !( this -> shipped_keys ) )
+		return;
+
+	this -> shipped_keys -> intern ();
+	this -> shipped_keys.reset ();
+}
+
+/**
+ * Writes little endian integer into a buffer
+ *
+ * @param buffer - The buffer which recieves the 8 bytes
+ * @param value - The value which should be written
+ */
+static void write_integer ( unsigned char *buffer, long long value ) {
+	for ( int x = 0; x < 8; x++ )
+		buffer[x] = (unsigned char)( (unsigned long long) value >> ( 8 * x ) );
+}
+
+/**
+ * Writes the block's fixed layout binary header, which is what the block's hash commits to
+ * (prev_block | merkel_tree | time | index | nonce, with the nonce last so that
+ * the rest of the header can be hashed once per mining run)
+ *
+ * @param header - The buffer of HEADER_SIZE bytes which recieves the header
+ */
+void Block::to_header ( unsigned char *header ) {
+	std::memcpy ( header, this -> prev_block.bytes, SHA256_DIGEST_LENGTH );
+	std::memcpy ( header + SHA256_DIGEST_LENGTH, this -> merkel_tree.bytes, SHA256_DIGEST_LENGTH );
+	write_integer ( header + 2 * SHA256_DIGEST_LENGTH, this -> time.count () );
+	write_integer ( header + 2 * SHA256_DIGEST_LENGTH + 8, this -> index );
+	write_integer ( header + HEADER_PREFIX_SIZE, this -> nonce );
+}
+
+/**
+ * Finalizes the header and hashes its constant part, which every nonce shares
+ *
+ * @returns The hashing state after the header's prefix
+ */
+crypto::sha256_midstate Block::header_midstate () {
+	this -> calculate_merkel_tree ();
+
+	unsigned char header[HEADER_SIZE];
+	this -> to_header ( header );
+	return crypto::sha256_prefix ( header, HEADER_PREFIX_SIZE );
 }
 
 /**
  * Mines the current block
  */
 void Block::mine_block () {
-	while ( !( this -> is_mined () ) ) {
-		nonce++;
-		this -> calculate_hash ();
+	this -> mine_block ( 1 );
+}
+
+/**
+ * Mines the current block by splitting the nonce space across several threads
+ * (Worker n tries every nonce congruent to n modulo the thread count)
+ *
+ * @param threads - The number of worker threads (0 uses every available core)
+ */
+void Block::mine_block ( unsigned int threads ) {
+
+	if ( threads == 0 )
+		threads = std::max ( std::thread::hardware_concurrency (), 1u );
+
+	crypto::sha256_midstate midstate = this -> header_midstate ();
+
+	std::atomic<bool> found ( false );
+	long long result = this -> nonce;
+	long long start = this -> nonce;
+
+	if ( threads == 1 )
+		this -> search_nonce ( midstate, start, 1, found, result );
+	else {
+
+		// Starts the workers
+		std::vector<std::thread> workers;
+		for ( unsigned int worker = 0; worker < threads; worker++ ) {
+			workers.emplace_back ( [this, &midstate, &found, &result, start, threads, worker] () {
+				long long nonce;
+				if ( this -> search_nonce ( midstate, start + worker, threads, found, nonce ) )
+					result = nonce;
+			} );
+		}
+
+		for ( auto &worker : workers )
+			worker.join ();
+	}
+
+	// Writes the result back into the block
+	this -> nonce = result;
+	this -> calculate_hash ();
+}
+
+/**
+ * Searches part of the nonce space for a nonce which mines the block
+ * (Candidates are hashed MINING_BATCH at a time so the SIMD kernels get full lanes)
+ *
+ * @param midstate - The hashing state after the header's constant prefix
+ * @param start - The first nonce which should be tried
+ * @param step - The distance between two tried nonces
+ * @param found - Set by the first worker to find a valid nonce, stops every other worker
+ * @param nonce - Recieves the valid nonce
+ * @returns Whether or not this worker was the first to find a valid nonce
+ */
+bool Block::search_nonce ( const crypto::sha256_midstate &midstate, long long start, long long step, std::atomic<bool> &found, long long &nonce ) {
+	for ( long long candidate = start; !found.load ( std::memory_order_relaxed ); candidate += step * MINING_BATCH ) {
+		long long valid;
+		if ( !( this -> search_batch ( midstate, candidate, step, valid ) ) )
+			continue;
+
+		// Only the first worker to find a valid nonce reports it
+		if ( found.exchange ( true ) )
+			return false;
+
+		nonce = valid;
+		return true;
 	}
+
+	return false;
+}
+
+/**
+ * Hashes MINING_BATCH candidate nonces side by side
+ *
+ * @param midstate - The hashing state after the header's constant prefix
+ * @param start - The first nonce which should be tried
+ * @param step - The distance between two tried nonces
+ * @param nonce - Recieves the first valid nonce in the batch
+ * @returns Whether or not the batch contained a valid nonce
+ */
+bool Block::search_batch ( const crypto::sha256_midstate &midstate, long long start, long long step, long long &nonce ) const {
+	unsigned char suffixes[MINING_BATCH][8];
+	const unsigned char *suffix_pointers[MINING_BATCH];
+	unsigned char digests[MINING_BATCH][SHA256_DIGEST_LENGTH];
+
+	for ( int x = 0; x < MINING_BATCH; x++ ) {
+		write_integer ( suffixes[x], start + step * x );
+		suffix_pointers[x] = suffixes[x];
+	}
+
+	crypto::sha256_suffix_many ( midstate, suffix_pointers, sizeof ( suffixes[0] ), MINING_BATCH, digests[0] );
+
+	for ( int x = 0; x < MINING_BATCH; x++ )
+		if ( this -> is_mined ( digests[x] ) ) {
+			nonce = start + step * x;
+			return true;
+		}
+
+	return false;
 }
 
 /**
@@ -304,10 +744,26 @@ void Block::set_timestamp () {
  * @returns Whether or not the block has been mined
  */
 bool Block::is_mined () {
-	for ( auto c : this -> hash.substr ( 0, this -> difficulty ) )
-		if ( c != '0' )
+	return this -> is_mined ( this -> hash.bytes );
+}
+
+/**
+ * Checks if a raw digest satisfies the block's difficulty
+ * (The difficulty counts leading zero nibbles, i.e. hex digits)
+ *
+ * @param digest - The raw SHA256 digest which should be checked
+ * @returns Whether or not the digest would mine the block
+ */
+bool Block::is_mined ( const unsigned char *digest ) const {
+	int bytes = std::min ( this -> difficulty, 2 * SHA256_DIGEST_LENGTH ) / 2;
+	for ( int x = 0; x < bytes; x++ )
+		if ( digest[x] != 0 )
 			return false;
 
+	// Checks the high nibble of an odd difficulty
+	if ( this -> difficulty % 2 && bytes < SHA256_DIGEST_LENGTH )
+		return ( digest[bytes] & 0xF0 ) == 0;
+
 	return true;
 }
 
@@ -335,9 +791,9 @@ void Block::print ( bool is_genesis ) {
 	std::cout << "===== BLOCK =====" << std::endl;
 	std::cout << "Index: " << this -> index << std::endl;
 	std::cout << "Timestamp: " << this -> time.count () << std::endl;
-	std::cout << "Hash: " << this -> hash << std::endl;
-	std::cout << "Merkl Root: " << this -> merkel_tree << std::endl;
-	std::cout << "Prev Block: " << this -> prev_block << std::endl;
+	std::cout << "Hash: " << this -> hash.to_hex () << std::endl;
+	std::cout << "Merkl Root: " << this -> merkel_tree.to_hex () << std::endl;
+	std::cout << "Prev Block: " << this -> prev_block.to_hex () << std::endl;
 	std::cout << "Nonce: " << this -> nonce << std::endl;
 	std::cout << "Mined: " << this -> is_mined () << std::endl;
 	std::cout << "Valid: " << this -> verify ( is_genesis ) << std::endl;
@@ -348,6 +804,6 @@ void Block::print ( bool is_genesis ) {
 
 	// Prints the transactions
 	if ( this -> transactions.size () > 1 )
-		for ( std::vector<Transaction>::iterator transaction = this -> transactions.begin () + 1; transaction != this -> transactions.end (); transaction++ )
+		for ( std::pmr::vector<Transaction>::iterator transaction = this -> transactions.begin () + 1; transaction != this -> transactions.end (); transaction++ )
 			transaction -> print ( false );
 }
\ No newline at end of file
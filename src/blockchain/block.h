@@ -4,49 +4,87 @@
 
 #include <string>
 #include <vector>
+#include <memory_resource>
 #include <sstream>
 #include <chrono>
+#include <thread>
+#include <atomic>
+#include <unordered_set>
 #include "transaction.h"
+#include "key_table.h"
 #include "algorithms/crypto.h"
+#include "algorithms/serialize.h"
+#include "algorithms/merkle_tree.h"
+#include "algorithms/parallel.h"
 
 class Block {
 	public:
+		static const size_t HEADER_SIZE = 2 * SHA256_DIGEST_LENGTH + 3 * 8;
+		static const size_t HEADER_PREFIX_SIZE = HEADER_SIZE - 8;
+		static const int MINING_BATCH = 8;
+
+		typedef std::pmr::polymorphic_allocator<char> allocator_type;
+
 		int difficulty;
-		std::string hash;
-		std::string prev_block;
-		std::string merkel_tree;
+		Hash256 hash;
+		Hash256 prev_block;
+		Hash256 merkel_tree;
 		std::chrono::milliseconds time;
 		long long nonce;
 		long index;
-		std::vector<Transaction> transactions;
+		std::pmr::vector<Transaction> transactions;
 
-		Block ( std::string prev_block, long index, Transaction coinbase, int difficulty );
-		Block ( std::string prev_block, long index, int difficulty );
+		Block ( Hash256 prev_block, long index, Transaction coinbase, int difficulty );
+		Block ( Hash256 prev_block, long index, int difficulty );
 		Block ();
+		explicit Block ( const allocator_type &allocator );
 
-		void add_transaction ( Transaction transaction );
+		void add_transaction ( const Transaction &transaction );
+		void add_transaction ( Transaction &&transaction );
+		std::vector<bool> add_transactions ( std::vector<Transaction> &transactions, unsigned int threads );
 		void set_coinbase ( Transaction coinbase );
 
 		void calculate_hash ();
 		void calculate_merkel_tree ();
+		MerkleProof merkle_proof ( long tx_index );
 
 		bool verify_hash ();
 		bool verify_merkel_tree ();
 		bool verify_transactions ();
+		bool verify_transactions ( unsigned int threads );
 		bool verify_coinbase ( long reward );
 		bool verify ( bool is_genesis );
 		bool verify ( bool is_genesis, long reward );
+		bool verify ( bool is_genesis, long reward, unsigned int threads );
+		bool verify_structure ( bool is_genesis, long reward );
+		bool verify_header ( bool is_genesis, long reward );
+		bool verify_signatures ();
+		bool verify_signatures ( unsigned int threads );
 
-		std::string to_string ( bool is_hash );
+		void encode ( serialize::Writer &writer );
+		std::string to_bytes ();
+		static Block decode ( serialize::Span bytes, const allocator_type &allocator = {} );
+		void intern_keys ();
+		void to_header ( unsigned char *header );
+		crypto::sha256_midstate header_midstate ();
+		bool search_batch ( const crypto::sha256_midstate &midstate, long long start, long long step, long long &nonce ) const;
 
 		void mine_block ();
+		void mine_block ( unsigned int threads );
 
 
 		void print ( bool is_genesis );
 
 	private:
+		MerkleTree tree;
+		bool has_coinbase;
+		std::shared_ptr<KeyTable::Scope> shipped_keys;
+
 		void set_timestamp ();
+		std::vector<KeyTable::Handle> signing_keys ();
 		bool is_mined ();
+		bool is_mined ( const unsigned char *digest ) const;
+		bool search_nonce ( const crypto::sha256_midstate &midstate, long long start, long long step, std::atomic<bool> &found, long long &nonce );
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,354 @@
+#include "block_store.h"
+
+/**
+ * Opens a block store, indexing any blocks which were already written to it
+ * (Only the record framing and each block's layout are checked, the blocks
+ * themselves were verified before they were appended)
+ *
+ * @param path - The directory holding the segment files, or "" to keep everything in memory
+ */
+BlockStore::BlockStore ( std::string path ) {
+	this -> path = path;
+	if ( path.empty () )
+		return;
+
+	std::filesystem::create_directories ( path );
+
+	for ( uint32_t segment = 0; std::filesystem::exists ( this -> segment_path ( segment ) ); segment++ )
+		this -> load_segment ( segment );
+}
+
+/**
+ * Closes the store
+ * (A segment is unmapped once the last pin into it is released, which may be after this)
+ */
+BlockStore::~BlockStore () {
+	for ( auto &segment : this -> segments )
+		if ( segment.file >= 0 )
+			close ( segment.file );
+}
+
+/**
+ * Gets the number of stored blocks
+ *
+ * @returns The chain's height
+ */
+size_t BlockStore::size () const {
+	return this -> headers.size ();
+}
+
+bool BlockStore::empty () const {
+	return this -> headers.empty ();
+}
+
+/**
+ * Gets a stored block's header without touching the segments
+ *
+ * @param height - The block's position in the chain
+ * @returns The block's header
+ */
+const BlockHeader &BlockStore::header ( size_t height ) const {
+	if ( height >= this -> headers.size () )
+		throw std::runtime_error ( "Attempted reading a block outside the store!" );
+
+	return this -> headers[height];
+}
+
+const BlockHeader &BlockStore::back () const {
+	if ( this -> headers.empty () )
+		throw std::runtime_error ( "Attempted reading a block outside the store!" );
+
+	return this -> headers.back ();
+}
+
+/**
+ * Gets a stored block's encoding, straight out of its segment's memory map
+ *
+ * @param height - The block's position in the chain
+ * @returns The bytes, which stay valid for as long as the store is open
+ */
+serialize::Span BlockStore::bytes ( size_t height ) const {
+	const BlockLocation &location = this -> header ( height ).location;
+	const Segment &segment = this -> segments[location.segment];
+	return serialize::Span { segment.data + location.offset, location.size };
+}
+
+/**
+ * Gets a stored block's pin
+ * (While a copy is held, the block's bytes stay in place even if the block is removed)
+ *
+ * @param height - The block's position in the chain
+ * @returns The pin
+ */
+std::shared_ptr<const void> BlockStore::pin ( size_t height ) const {
+	this -> header ( height );
+	return this -> pins[height];
+}
+
+/**
+ * Gets a view of a stored block
+ *
+ * @param height - The block's position in the chain
+ * @returns A view which stays valid for as long as the store is open
+ */
+BlockView BlockStore::view ( size_t height ) const {
+	return BlockView ( this -> bytes ( height ) );
+}
+
+/**
+ * Decodes a stored block
+ *
+ * @param height - The block's position in the chain
+ * @returns A copy of the block
+ */
+Block BlockStore::get_block ( size_t height ) const {
+	return this -> view ( height ).to_block ();
+}
+
+/**
+ * Appends a block to the store, starting a new segment when the current one is full
+ *
+ * @param block - The block, which must extend the current tip
+ */
+void BlockStore::append ( Block &block ) {
+	if ( !this -> headers.empty () && block.prev_block != this -> headers.back ().hash )
+		throw std::runtime_error ( "Attempted storing a block which doesn't extend the tip!" );
+
+	// Measures the block
+	serialize::Writer counter;
+	block.encode ( counter );
+
+	uint64_t length = RECORD_HEADER_SIZE + counter.size ();
+	if ( length > SEGMENT_SIZE )
+		throw std::runtime_error ( "Block is too large to store!" );
+
+	// Gives back the space of removed blocks which are no longer pinned, the rest is left behind
+	this -> reclaim ();
+	this -> removed.clear ();
+
+	uint32_t current = this -> segments.empty () ? 0 : this -> segments.size () - 1;
+	if ( this -> segments.empty () || this -> segments.back ().size + length > SEGMENT_SIZE )
+		current = this -> segments.empty () ? 0 : current + 1;
+
+	Segment &segment = current < this -> segments.size () ? this -> segments[current] : this -> open_segment ( current );
+
+	// Encodes the record
+	std::string record ( length, '\0' );
+	serialize::Writer writer ( reinterpret_cast<unsigned char*> ( &record[0] ), record.size () );
+	writer.u32 ( RECORD_MAGIC );
+	writer.u32 ( (uint32_t) counter.size () );
+	writer.u32 ( 0 );
+	block.encode ( writer );
+
+	serialize::Writer checksum ( reinterpret_cast<unsigned char*> ( &record[8] ), 4 );
+	checksum.u32 ( serialize::crc32 ( reinterpret_cast<const unsigned char*> ( record.data () ) + RECORD_HEADER_SIZE, counter.size () ) );
+
+	// Writes the record after the segment's last one
+	if ( segment.file < 0 ) {
+		std::memcpy ( segment.data + segment.size, record.data (), record.size () );
+	} else {
+		size_t written = 0;
+		while ( written < record.size () ) {
+			ssize_t result = pwrite ( segment.file, record.data () + written, record.size () - written, segment.size + written );
+			if ( result < 0 )
+				throw std::runtime_error ( "Failed to write block to the store!" );
+
+			written += result;
+		}
+
+		if ( fdatasync ( segment.file ) != 0 )
+			throw std::runtime_error ( "Failed to write block to the store!" );
+	}
+
+	BlockLocation location { current, segment.size + RECORD_HEADER_SIZE, (uint32_t) counter.size () };
+	segment.size += length;
+
+	this -> index_block ( BlockView ( serialize::Span { segment.data + location.offset, location.size } ), location );
+}
+
+/**
+ * Removes the tip block from the store
+ * (Used when the chain reorganizes onto another branch. The record is marked
+ * as removed, which only touches its framing, never the block's bytes; it's
+ * cut off straight away unless its pin is still held, otherwise once a later
+ * removal or append finds it released. A segment left empty is deleted)
+ */
+void BlockStore::pop_back () {
+	if ( this -> headers.empty () )
+		throw std::runtime_error ( "Attempted removing a block from an empty store!" );
+
+	BlockLocation location = this -> headers.back ().location;
+	Segment &segment = this -> segments[location.segment];
+	uint64_t start = location.offset - RECORD_HEADER_SIZE;
+
+	unsigned char magic[4];
+	serialize::Writer writer ( magic, sizeof ( magic ) );
+	writer.u32 ( REMOVED_MAGIC );
+
+	if ( segment.file < 0 )
+		std::memcpy ( segment.data + start, magic, sizeof ( magic ) );
+	else if ( pwrite ( segment.file, magic, sizeof ( magic ), start ) != sizeof ( magic ) )
+		throw std::runtime_error ( "Failed to remove block from the store!" );
+
+	this -> removed.push_back ( RemovedRecord { this -> pins.back (), location.segment, start, location.offset + location.size } );
+	this -> headers.pop_back ();
+	this -> pins.pop_back ();
+	this -> reclaim ();
+}
+
+/**
+ * Cuts removed records which are no longer pinned off the end of the store
+ * (Stops at the first one which is still pinned, or at a live block; a
+ * segment left empty is deleted, and is unmapped once its last pin is released)
+ */
+void BlockStore::reclaim () {
+	uint32_t last = this -> segments.size () - 1;
+	uint64_t size = this -> segments.empty () ? 0 : this -> segments.back ().size;
+
+	while ( !( this -> segments.empty () ) ) {
+		Segment &segment = this -> segments.back ();
+		auto tail = std::find_if ( this -> removed.begin (), this -> removed.end (), [&] ( const RemovedRecord &record ) {
+			return record.segment == this -> segments.size () - 1 && record.end == segment.size;
+		} );
+
+		if ( tail == this -> removed.end () || !( tail -> pin.expired () ) )
+			break;
+
+		segment.size = tail -> start;
+		this -> removed.erase ( tail );
+
+		// Drops the segment once it's empty
+		if ( segment.size == 0 && this -> segments.size () > 1 ) {
+			if ( segment.file >= 0 ) {
+				close ( segment.file );
+				std::filesystem::remove ( this -> segment_path ( this -> segments.size () - 1 ) );
+			}
+
+			this -> segments.pop_back ();
+		}
+	}
+
+	// Truncates the last segment's file if its end moved
+	if ( this -> segments.empty () )
+		return;
+
+	Segment &segment = this -> segments.back ();
+	if ( segment.file >= 0 && ( this -> segments.size () - 1 != last || segment.size != size ) && ftruncate ( segment.file, segment.size ) != 0 )
+		throw std::runtime_error ( "Failed to remove block from the store!" );
+}
+
+/**
+ * Gets a segment's file name
+ *
+ * @param segment - The segment's number
+ * @returns The segment's path
+ */
+std::string BlockStore::segment_path ( uint32_t segment ) const {
+	char name[32];
+	snprintf ( name, sizeof ( name ), "blk%05u.dat", segment );
+	return ( std::filesystem::path ( this -> path ) / name ).string ();
+}
+
+/**
+ * Opens (or creates) a segment and maps it
+ * (The whole SEGMENT_SIZE is mapped up front so that appends never remap,
+ * only the part of the mapping backed by the file is ever read)
+ *
+ * @param segment - The segment's number, which must be the next one
+ * @returns The opened segment
+ */
+BlockStore::Segment &BlockStore::open_segment ( uint32_t segment ) {
+	Segment opened { -1, nullptr, 0, nullptr };
+
+	if ( this -> path.empty () ) {
+		void *data = mmap ( nullptr, SEGMENT_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0 );
+		if ( data == MAP_FAILED )
+			throw std::runtime_error ( "Failed to map block store segment!" );
+
+		opened.data = static_cast<unsigned char*> ( data );
+		opened.mapping = std::shared_ptr<unsigned char> ( opened.data, [] ( unsigned char *data ) { munmap ( data, SEGMENT_SIZE ); } );
+	} else {
+		opened.file = open ( this -> segment_path ( segment ).c_str (), O_RDWR | O_CREAT, 0644 );
+		if ( opened.file < 0 )
+			throw std::runtime_error ( "Failed to open block store segment!" );
+
+		off_t size = lseek ( opened.file, 0, SEEK_END );
+		void *data = mmap ( nullptr, SEGMENT_SIZE, PROT_READ, MAP_SHARED, opened.file, 0 );
+		if ( size < 0 || data == MAP_FAILED ) {
+			close ( opened.file );
+			throw std::runtime_error ( "Failed to map block store segment!" );
+		}
+
+		opened.data = static_cast<unsigned char*> ( data );
+		opened.mapping = std::shared_ptr<unsigned char> ( opened.data, [] ( unsigned char *data ) { munmap ( data, SEGMENT_SIZE ); } );
+		opened.size = size;
+	}
+
+	this -> segments.push_back ( opened );
+	return this -> segments.back ();
+}
+
+/**
+ * Indexes every record in an existing segment
+ * (Each record is magic | length | CRC-32 | block. A record running past the
+ * end of the last segment was torn by a crash during an append and is cut
+ * off; any other bad record means the store is corrupt. Removed records are
+ * skipped, and cut off by the next append if they're at the end)
+ *
+ * @param segment - The segment's number
+ */
+void BlockStore::load_segment ( uint32_t segment ) {
+	Segment &opened = this -> open_segment ( segment );
+	if ( opened.size > SEGMENT_SIZE )
+		throw std::runtime_error ( "Corrupt block store segment!" );
+
+	uint64_t offset = 0;
+	while ( offset < opened.size ) {
+		const unsigned char *record = opened.data + offset;
+		uint64_t remaining = opened.size - offset;
+
+		uint32_t magic = remaining >= 4 ? serialize::read_u32 ( record ) : RECORD_MAGIC;
+		if ( magic != RECORD_MAGIC && magic != REMOVED_MAGIC )
+			throw std::runtime_error ( "Corrupt block store record!" );
+
+		// Cuts off a torn record
+		if ( remaining < RECORD_HEADER_SIZE || RECORD_HEADER_SIZE + serialize::read_u32 ( record + 4 ) > remaining ) {
+			if ( std::filesystem::exists ( this -> segment_path ( segment + 1 ) ) )
+				throw std::runtime_error ( "Corrupt block store segment!" );
+
+			if ( ftruncate ( opened.file, offset ) != 0 )
+				throw std::runtime_error ( "Failed to repair block store segment!" );
+
+			opened.size = offset;
+			break;
+		}
+
+		uint32_t length = serialize::read_u32 ( record + 4 );
+		if ( magic == REMOVED_MAGIC ) {
+			this -> removed.push_back ( RemovedRecord { std::weak_ptr<const void> (), segment, offset, offset + RECORD_HEADER_SIZE + length } );
+			offset += RECORD_HEADER_SIZE + length;
+			continue;
+		}
+
+		if ( serialize::read_u32 ( record + 8 ) != serialize::crc32 ( record + RECORD_HEADER_SIZE, length ) )
+			throw std::runtime_error ( "Corrupt block store record!" );
+
+		BlockLocation location { segment, offset + RECORD_HEADER_SIZE, length };
+		this -> index_block ( BlockView ( serialize::Span { record + RECORD_HEADER_SIZE, length } ), location );
+		offset += RECORD_HEADER_SIZE + length;
+	}
+}
+
+/**
+ * Adds a block to the header index
+ *
+ * @param block - A view of the stored block
+ * @param location - Where the block is stored
+ */
+void BlockStore::index_block ( BlockView block, BlockLocation location ) {
+	if ( !this -> headers.empty () && block.prev_block () != this -> headers.back ().hash )
+		throw std::runtime_error ( "Stored block doesn't extend the tip!" );
+
+	this -> headers.push_back ( BlockHeader { block.hash (), block.prev_block (), block.index (), block.transaction_count (), location } );
+	this -> pins.push_back ( std::make_shared<const std::shared_ptr<unsigned char>> ( this -> segments[location.segment].mapping ) );
+}
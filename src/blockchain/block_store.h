@@ -0,0 +1,101 @@
+#pragma once
+#ifndef BLOCK_STORE_H
+#define BLOCK_STORE_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <algorithm>
+#include <stdexcept>
+#include <filesystem>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include "block.h"
+#include "views.h"
+#include "algorithms/serialize.h"
+
+/**
+ * Where a block's encoding lives in the store
+ */
+struct BlockLocation {
+	uint32_t segment;
+	uint64_t offset;
+	uint32_t size;
+};
+
+/**
+ * The part of a stored block which is kept in memory
+ */
+struct BlockHeader {
+	Hash256 hash;
+	Hash256 prev_block;
+	long index;
+	size_t transactions;
+	BlockLocation location;
+};
+
+/**
+ * An append-only store of encoded blocks, split over fixed size segment files
+ * (Blocks are read back through read-only memory maps, so only the header
+ * index stays resident; an empty path keeps the segments in anonymous memory.
+ * Every block has a pin, which keeps its bytes in place while it's held: a
+ * removed block's record is marked as removed, and its space is only reused
+ * or unmapped once every copy of its pin has been released)
+ */
+class BlockStore {
+	public:
+		static const uint64_t SEGMENT_SIZE = 1ULL << 27;
+		static const uint32_t RECORD_MAGIC = 0x4B434C42;
+		static const uint32_t REMOVED_MAGIC = 0x444D4552;
+		static const size_t RECORD_HEADER_SIZE = 12;
+
+		BlockStore ( std::string path );
+		~BlockStore ();
+
+		BlockStore ( const BlockStore & ) = delete;
+		BlockStore &operator= ( const BlockStore & ) = delete;
+
+		size_t size () const;
+		bool empty () const;
+		const BlockHeader &header ( size_t height ) const;
+		const BlockHeader &back () const;
+
+		serialize::Span bytes ( size_t height ) const;
+		std::shared_ptr<const void> pin ( size_t height ) const;
+		BlockView view ( size_t height ) const;
+		Block get_block ( size_t height ) const;
+
+		void append ( Block &block );
+		void pop_back ();
+
+	private:
+		struct Segment {
+			int file;
+			unsigned char *data;
+			uint64_t size;
+			std::shared_ptr<unsigned char> mapping;
+		};
+
+		struct RemovedRecord {
+			std::weak_ptr<const void> pin;
+			uint32_t segment;
+			uint64_t start;
+			uint64_t end;
+		};
+
+		std::string path;
+		std::vector<Segment> segments;
+		std::vector<BlockHeader> headers;
+		std::vector<std::shared_ptr<const void>> pins;
+		std::vector<RemovedRecord> removed;
+
+		std::string segment_path ( uint32_t segment ) const;
+		Segment &open_segment ( uint32_t segment );
+		void load_segment ( uint32_t segment );
+		void index_block ( BlockView block, BlockLocation location );
+		void reclaim ();
+};
+
+#endif
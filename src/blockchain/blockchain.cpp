@@ -1,9 +1,110 @@
 #include "blockchain.h"
 
-Blockchain::Blockchain ( int difficulty, long reward, Transaction coinbase ) {
+/**
+ * The blockchain constructor (mines on every available core)
+ *
+ * @param difficulty - The mining difficulty
+ * @param reward - The mining reward
+ * @param coinbase - The genesis block's coinbase
+ */
+Blockchain::Blockchain ( int difficulty, long reward, Transaction coinbase ): Blockchain ( difficulty, reward, std::move ( coinbase ), std::thread::hardware_concurrency () ) {}
+
+/**
+ * The blockchain constructor
+ *
+ * @param difficulty - The mining difficulty
+ * @param reward - The mining reward
+ * @param coinbase - The genesis block's coinbase
+ * @param threads - The number of threads used to mine each block
+ */
+Blockchain::Blockchain ( int difficulty, long reward, Transaction coinbase, unsigned int threads ): Blockchain ( difficulty, reward, std::move ( coinbase ), threads, "" ) {}
+
+/**
+ * The blockchain constructor
+ * (Reopens the chain stored at the path if there is one, in which case the
+ * coinbase is ignored)
+ *
+ * @param difficulty - The mining difficulty
+ * @param reward - The mining reward
+ * @param coinbase - The genesis block's coinbase
+ * @param threads - The number of threads used to mine each block
+ * @param path - The directory which stores the blocks ("" keeps them in memory)
+ */
+Blockchain::Blockchain ( int difficulty, long reward, Transaction coinbase, unsigned int threads, std::string path ): blocks ( path ), mempool ( [this] ( const Hash256 &outpoint, int64_t &value ) { return this -> find_output ( outpoint, value ); } ) {
+	this -> difficulty = difficulty;
+	this -> reward = reward;
+	this -> threads = threads;
+	this -> assume_valid = Hash256 {};
+	this -> indexed = 0;
+	this -> revision = 0;
+
+	if ( this -> blocks.empty () )
+		this -> create_genesis_block ( std::move ( coinbase ) );
+	else if ( !( this -> verify_chain () ) )
+		throw std::runtime_error ( "Stored blockchain is invalid!" );
+
+	this -> create_block ();
+}
+
+/**
+ * Reopens an existing blockchain, fully verifying every stored block
+ *
+ * @param path - The directory which stores the blocks
+ * @param difficulty - The mining difficulty
+ * @param reward - The mining reward
+ * @param threads - The number of threads used to mine and verify blocks
+ */
+Blockchain::Blockchain ( std::string path, int difficulty, long reward, unsigned int threads ): Blockchain ( path, difficulty, reward, threads, Hash256 {} ) {}
+
+/**
+ * Reopens an existing blockchain
+ * (The assume valid block and its ancestors only get structural checks)
+ *
+ * @param path - The directory which stores the blocks
+ * @param difficulty - The mining difficulty
+ * @param reward - The mining reward
+ * @param threads - The number of threads used to mine and verify blocks
+ * @param assume_valid - The hash of a block whose signatures are known to be valid (zero for none)
+ */
+Blockchain::Blockchain ( std::string path, int difficulty, long reward, unsigned int threads, Hash256 assume_valid ): blocks ( path ), mempool ( [this] ( const Hash256 &outpoint, int64_t &value ) { return this -> find_output ( outpoint, value ); } ) {
+	if ( this -> blocks.empty () )
+		throw std::runtime_error ( "No blockchain to reopen!" );
+
+	this -> difficulty = difficulty;
+	this -> reward = reward;
+	this -> threads = threads;
+	this -> assume_valid = assume_valid;
+	this -> indexed = 0;
+	this -> revision = 0;
+
+	if ( !( this -> verify_chain () ) )
+		throw std::runtime_error ( "Stored blockchain is invalid!" );
+
+	this -> create_block ();
+}
+
+/**
+ * Starts an in-memory chain from an existing genesis block
+ * (So that several chains, such as a simulated network's nodes, share one history)
+ *
+ * @param genesis - The mined genesis block
+ * @param difficulty - The mining difficulty
+ * @param reward - The mining reward
+ * @param threads - The number of threads used to mine and verify blocks
+ */
+Blockchain::Blockchain ( Block genesis, int difficulty, long reward, unsigned int threads ): blocks ( "" ), mempool ( [this] ( const Hash256 &outpoint, int64_t &value ) { return this -> find_output ( outpoint, value ); } ) {
 	this -> difficulty = difficulty;
 	this -> reward = reward;
-	this -> create_genesis_block ( coinbase );
+	this -> threads = threads;
+	this -> assume_valid = Hash256 {};
+	this -> indexed = 0;
+	this -> revision = 0;
+
+	if ( !( genesis.prev_block.is_zero () ) || genesis.index != 0 || genesis.difficulty != difficulty || !( genesis.verify ( true, reward, threads ) ) )
+		throw std::runtime_error ( "Attempted starting a chain from an invalid genesis block!" );
+
+	this -> blocks.append ( genesis );
+	this -> index_blocks ();
 	this -> create_block ();
 }
 
@@ -18,15 +119,630 @@ void Blockchain::mine_block ( Transaction coinbase ) {
 	if ( !( this -> verify_coinbase ( coinbase ) ) )
 		throw std::runtime_error ( "Invalid coinbase transaction!" );
 
-	this -> current_block.set_coinbase ( coinbase );
+	this -> fill_block ( this -> current_block, this -> mempool.take ( BLOCK_ASSEMBLY_BYTES ), this -> pending_spends );
+	this -> current_block.set_coinbase ( std::move ( coinbase ) );
 
 	// Mines the block
-	this -> current_block.mine_block ();
+	this -> current_block.mine_block ( this -> threads );
 	this -> insert_block ();
 }
 
-void Blockchain::add_transaction ( Transaction transaction ) {
-	this -> current_block.add_transaction ( transaction );
+/**
+ * Assembles a block template on the active tip, ready to be mined
+ * (The transactions are copied from the mempool, which keeps them until a
+ * block spending their inputs is connected, so a template can be rebuilt as
+ * often as needed)
+ *
+ * @param coinbase - The template's coinbase transaction
+ * @returns The unmined block
+ */
+Block Blockchain::create_template ( Transaction coinbase ) {
+	if ( !( this -> verify_coinbase ( coinbase ) ) )
+		throw std::runtime_error ( "Invalid coinbase transaction!" );
+
+	const BlockHeader &tip = this -> blocks.back ();
+	Block block ( tip.hash, tip.index + tip.transactions, this -> difficulty );
+
+	std::unordered_map<Hash256, uint32_t> spends;
+	this -> fill_block ( block, this -> mempool.select ( BLOCK_ASSEMBLY_BYTES ), spends );
+	block.set_coinbase ( std::move ( coinbase ) );
+	return block;
+}
+
+/**
+ * Gets a counter which changes whenever a block is connected or disconnected
+ * (Safe to read from any thread, so miners can notice a new tip mid-search)
+ *
+ * @returns The chain's revision
+ */
+uint64_t Blockchain::get_revision () {
+	return this -> revision.load ();
+}
+
+/**
+ * Accepts a mined block from elsewhere, which may extend any known branch
+ * (Blocks are fully verified on arrival; the chain switches to a branch once
+ * it has more work than the active chain, disconnecting and reconnecting only
+ * the blocks above the fork. Branches must fork within MAX_REORG_DEPTH blocks
+ * of the tip)
+ *
+ * @param block - The block
+ * @returns Whether or not the block is now part of the active chain
+ */
+bool Blockchain::accept_block ( Block block ) {
+	return this -> accept_block ( std::move ( block ), false );
+}
+
+/**
+ * Accepts a mined block from elsewhere
+ *
+ * @param block - The block
+ * @param is_verified - Whether or not Block::verify already passed for the block (its position in the chain is always checked)
+ * @returns Whether or not the block is now part of the active chain
+ */
+bool Blockchain::accept_block ( Block block, bool is_verified ) {
+	if ( this -> heights.count ( block.hash ) != 0 || this -> side_blocks.count ( block.hash ) != 0 )
+		return this -> heights.count ( block.hash ) != 0;
+
+	// Finds the block's parent
+	double parent_work;
+	size_t height;
+	long index;
+	auto active = this -> heights.find ( block.prev_block );
+	if ( active != this -> heights.end () ) {
+		const BlockHeader &parent = this -> blocks.header ( active -> second );
+		parent_work = this -> chainwork[active -> second];
+		height = active -> second + 1;
+		index = parent.index + parent.transactions;
+	} else {
+		auto side = this -> side_blocks.find ( block.prev_block );
+		if ( side == this -> side_blocks.end () )
+			throw std::runtime_error ( "Attempted accepting a block with an unknown parent!" );
+
+		parent_work = side -> second.chainwork;
+		height = side -> second.height + 1;
+		index = side -> second.block.index + side -> second.block.transactions.size ();
+	}
+
+	if ( height + MAX_REORG_DEPTH < this -> blocks.size () )
+		throw std::runtime_error ( "Attempted accepting a block below the maximum reorganization depth!" );
+
+	if ( block.index != index || block.difficulty != this -> difficulty || !( is_verified || block.verify ( false, this -> reward, this -> threads ) ) )
+		throw std::runtime_error ( "Attempted accepting an invalid block!" );
+
+	block.intern_keys ();
+
+	Hash256 hash = block.hash;
+	double work = parent_work + block_work ( block.difficulty );
+	this -> side_blocks.emplace ( hash, SideBlock { std::move ( block ), work, height } );
+
+	if ( work <= this -> chainwork.back () )
+		return false;
+
+	this -> reorganize ( hash );
+	this -> prune_side_blocks ();
+	return true;
+}
+
+/**
+ * Forgets the side blocks which are too deep to ever be reorganized onto
+ * (A branch must fork within MAX_REORG_DEPTH blocks of the tip, which is also
+ * as far back as undo records are kept. Blocks left without their parent
+ * only go once they're that deep too, and can't be reorganized onto meanwhile)
+ */
+void Blockchain::prune_side_blocks () {
+	for ( auto side = this -> side_blocks.begin (); side != this -> side_blocks.end (); )
+		if ( side -> second.height + MAX_REORG_DEPTH < this -> blocks.size () )
+			side = this -> side_blocks.erase ( side );
+		else
+			side++;
+}
+
+/**
+ * Switches the active chain to the branch ending at a side block
+ * (If a block on the branch spends an unavailable output, the branch is
+ * dropped from that block on and the previous chain is restored, along with
+ * the pooled transactions connecting the branch removed. A block extending
+ * the tip costs nothing beyond connecting it)
+ *
+ * @param tip - The hash of the branch's last block
+ */
+void Blockchain::reorganize ( const Hash256 &tip ) {
+
+	// Collects the branch back to where it forks from the active chain
+	std::vector<Hash256> branch;
+	Hash256 cursor = tip;
+	while ( this -> heights.count ( cursor ) == 0 ) {
+		auto side = this -> side_blocks.find ( cursor );
+		if ( side == this -> side_blocks.end () )
+			throw std::runtime_error ( "Attempted reorganizing onto a branch which forks below the maximum reorganization depth!" );
+
+		branch.push_back ( cursor );
+		cursor = side -> second.block.prev_block;
+	}
+
+	size_t fork = this -> heights[cursor];
+	if ( this -> blocks.size () - 1 - fork > this -> undo.size () )
+		throw std::runtime_error ( "Attempted reorganizing onto a branch which forks below the maximum reorganization depth!" );
+
+	// Disconnects the active blocks above the fork
+	std::vector<Hash256> disconnected;
+	while ( this -> blocks.size () - 1 > fork ) {
+		double work = this -> chainwork.back ();
+		size_t height = this -> blocks.size () - 1;
+		Block block = this -> disconnect_block ();
+		Hash256 hash = block.hash;
+
+		disconnected.push_back ( hash );
+		this -> side_blocks.emplace ( hash, SideBlock { std::move ( block ), work, height } );
+	}
+
+	// Connects the branch, oldest block first, keeping what it takes out of the pool in case it has to be undone
+	std::vector<Transaction> unpooled;
+	for ( auto hash = branch.rbegin (); hash != branch.rend (); hash++ ) {
+		Block &block = this -> side_blocks.at ( *hash ).block;
+
+		if ( !( this -> verify_inputs ( block ) ) ) {
+
+			// Forgets the invalid block and its descendants on the branch
+			for ( auto invalid = branch.begin (); invalid != hash.base (); invalid++ )
+				this -> side_blocks.erase ( *invalid );
+
+			// Restores the previous chain
+			std::vector<Transaction> rolled_back;
+			while ( this -> blocks.size () - 1 > fork ) {
+				double work = this -> chainwork.back ();
+				size_t height = this -> blocks.size () - 1;
+				Block restored = this -> disconnect_block ();
+				Hash256 hash = restored.hash;
+
+				rolled_back.insert ( rolled_back.begin (), restored.transactions.begin () + 1, restored.transactions.end () );
+				this -> side_blocks.emplace ( hash, SideBlock { std::move ( restored ), work, height } );
+			}
+
+			for ( auto previous = disconnected.rbegin (); previous != disconnected.rend (); previous++ ) {
+				this -> blocks.append ( this -> side_blocks.at ( *previous ).block );
+				this -> side_blocks.erase ( *previous );
+				this -> index_blocks ();
+			}
+
+			// Returns the transactions which connecting the branch took out of the pool
+			unpooled.insert ( unpooled.end (), std::make_move_iterator ( rolled_back.begin () ), std::make_move_iterator ( rolled_back.end () ) );
+			this -> restore_transactions ( std::move ( unpooled ) );
+
+			throw std::runtime_error ( "Attempted reorganizing onto an invalid branch!" );
+		}
+
+		this -> blocks.append ( block );
+		this -> side_blocks.erase ( *hash );
+
+		std::vector<Transaction> removed = this -> index_blocks ();
+		unpooled.insert ( unpooled.end (), std::make_move_iterator ( removed.begin () ), std::make_move_iterator ( removed.end () ) );
+	}
+
+	// Collects the abandoned transactions in chain order, without their coinbases
+	std::vector<Transaction> pending;
+	for ( auto hash = disconnected.rbegin (); hash != disconnected.rend (); hash++ ) {
+		const Block &block = this -> side_blocks.at ( *hash ).block;
+		pending.insert ( pending.end (), block.transactions.begin () + 1, block.transactions.end () );
+	}
+
+	pending.insert ( pending.end (), this -> current_block.transactions.begin (), this -> current_block.transactions.end () );
+
+	// Starts a new block on the new tip, keeping whatever is still valid
+	this -> create_block ();
+	this -> restore_transactions ( std::move ( pending ) );
+}
+
+/**
+ * Returns transactions to the mempool, skipping the ones which are already mined or invalid
+ * (Checked against the UTXO set rather than by hash: a transaction's hash
+ * includes the tx_index it was mined at, which another branch may not share.
+ * Earlier transactions win when several spend the same output)
+ *
+ * @param transactions - The transactions, oldest first
+ */
+void Blockchain::restore_transactions ( std::vector<Transaction> transactions ) {
+	std::unordered_map<Hash256, uint32_t> spends;
+	for ( auto &transaction : transactions ) {
+		if ( !( this -> verify_inputs ( transaction, spends ) ) )
+			continue;
+
+		try {
+			this -> mempool.add ( std::move ( transaction ) );
+		} catch ( const std::runtime_error & ) {}
+	}
+}
+
+/**
+ * Gets the total work of the active chain
+ *
+ * @returns The sum of every active block's work
+ */
+double Blockchain::get_chainwork () {
+	return this -> chainwork.back ();
+}
+
+/**
+ * Gets the expected number of hashes needed to mine a block
+ *
+ * @param difficulty - The block's difficulty (leading zero hex digits)
+ * @returns The block's work
+ */
+double Blockchain::block_work ( int difficulty ) {
+	return std::pow ( 16.0, difficulty );
+}
+
+/**
+ * Reads a block from the chain
+ *
+ * @param height - The block's position in the chain (0 is the genesis block)
+ * @returns A copy of the block
+ */
+Block Blockchain::get_block ( size_t height ) {
+	return this -> blocks.get_block ( height );
+}
+
+/**
+ * Gets an immutable snapshot of the active chain
+ * (Safe to call from any thread, and never blocks the thread which updates
+ * the chain; blocks connected afterwards aren't visible through it)
+ *
+ * @returns The most recently published snapshot
+ */
+std::shared_ptr<const ChainSnapshot> Blockchain::snapshot () {
+	return this -> snapshots.current ();
+}
+
+/**
+ * Gets the number of blocks in the chain
+ *
+ * @returns The number of blocks, including the genesis block
+ */
+size_t Blockchain::height () {
+	return this -> blocks.size ();
+}
+
+/**
+ * Verifies every stored block and the links between them, rebuilding the
+ * indexes and the UTXO set as each block is connected
+ * (Blocks up to and including the assume valid block skip their signature
+ * checks; if that block isn't in the chain everything is fully verified)
+ *
+ * @returns Whether or not the whole chain is valid
+ */
+bool Blockchain::verify_chain () {
+	this -> transactions.clear ();
+	this -> addresses.clear ();
+	this -> snapshots.clear ();
+
+	{
+		std::unique_lock<std::shared_mutex> lock ( this -> utxo_mutex );
+		this -> utxos.clear ();
+	}
+
+	this -> heights.clear ();
+	this -> chainwork.clear ();
+	this -> undo.clear ();
+	this -> indexed = 0;
+
+	// Finds the checkpoint
+	size_t checkpoint = 0;
+	bool has_checkpoint = false;
+	if ( !( this -> assume_valid.is_zero () ) )
+		for ( size_t height = 0; height < this -> blocks.size (); height++ )
+			if ( this -> blocks.header ( height ).hash == this -> assume_valid ) {
+				checkpoint = height;
+				has_checkpoint = true;
+				break;
+			}
+
+	// Each block is decoded into the same arena, which is reset once the previous block is gone
+	std::pmr::monotonic_buffer_resource arena;
+	for ( size_t height = 0; height < this -> blocks.size (); height++ ) {
+		arena.release ();
+
+		Block block = Block::decode ( this -> blocks.bytes ( height ), &arena );
+		bool is_genesis = height == 0;
+
+		// Verifies the links to the previous block, and that the block was mined at the chain's difficulty
+		if ( block.difficulty != this -> difficulty )
+			return false;
+
+		if ( is_genesis ) {
+			if ( !( block.prev_block.is_zero () ) || block.index != 0 )
+				return false;
+		} else {
+			const BlockHeader &previous = this -> blocks.header ( height - 1 );
+			if ( block.prev_block != previous.hash || block.index != previous.index + (long) previous.transactions )
+				return false;
+		}
+
+		bool valid = has_checkpoint && height <= checkpoint ? block.verify_structure ( is_genesis, this -> reward ) : block.verify ( is_genesis, this -> reward, this -> threads );
+		if ( !valid || !( this -> verify_inputs ( block ) ) )
+			return false;
+
+		block.intern_keys ();
+
+		this -> connect_block ( height );
+		this -> indexed = height + 1;
+	}
+
+	return true;
+}
+
+/**
+ * Verifies that a block only spends unspent outputs, each at most once
+ *
+ * @param block - The block
+ * @returns Whether or not every input is available
+ */
+bool Blockchain::verify_inputs ( Block &block ) {
+	std::unordered_map<Hash256, uint32_t> spends;
+	for ( size_t position = 1; position < block.transactions.size (); position++ )
+		if ( !( this -> verify_inputs ( block.transactions[position], spends ) ) )
+			return false;
+
+	return true;
+}
+
+/**
+ * Verifies that a transaction only spends unspent outputs
+ * (An input's hash commits to the whole output it spends, so finding it in
+ * the UTXO set also proves the output's value and recipient)
+ *
+ * @param transaction - The transaction
+ * @param spends - The outputs already spent by earlier transactions in the same block (recieves this transaction's spends if it's valid)
+ * @returns Whether or not every input is available
+ */
+bool Blockchain::verify_inputs ( Transaction &transaction, std::unordered_map<Hash256, uint32_t> &spends ) {
+	std::unordered_map<Hash256, uint32_t> own;
+	for ( auto &input : transaction.inputs ) {
+		int64_t value;
+		uint32_t count;
+		if ( !( this -> utxos.find ( input.hash, value, count ) ) )
+			return false;
+
+		auto spent = spends.find ( input.hash );
+		if ( ( spent == spends.end () ? 0 : spent -> second ) + ++own[input.hash] > count )
+			return false;
+	}
+
+	// Only records the spends once every input is known to be available
+	for ( auto &spend : own )
+		spends[spend.first] += spend.second;
+
+	return true;
+}
+
+/**
+ * Finds an unspent output, for the mempool
+ * (Called from any thread submitting a transaction, so it's the one UTXO set
+ * read which takes the lock; only the chain's own thread writes the set)
+ *
+ * @param outpoint - The output's outpoint
+ * @param value - Recieves the output's value
+ * @returns Whether or not the output is unspent
+ */
+bool Blockchain::find_output ( const Hash256 &outpoint, int64_t &value ) {
+	std::shared_lock<std::shared_mutex> lock ( this -> utxo_mutex );
+	uint32_t copies;
+	return this -> utxos.find ( outpoint, value, copies );
+}
+
+/**
+ * Checks whether a transaction is in the chain
+ *
+ * @param hash - The transaction's hash
+ * @returns Whether or not the transaction has been mined
+ */
+bool Blockchain::has_transaction ( const Hash256 &hash ) {
+	TxLocation location;
+	return this -> transactions.find ( hash, location );
+}
+
+/**
+ * Finds a mined transaction by hash
+ *
+ * @param hash - The transaction's hash
+ * @returns A view of the stored transaction
+ */
+TransactionView Blockchain::get_transaction ( const Hash256 &hash ) {
+	TxLocation location;
+	if ( !( this -> transactions.find ( hash, location ) ) )
+		throw std::runtime_error ( "Transaction not found!" );
+
+	return this -> transaction_view ( location );
+}
+
+/**
+ * Finds a mined transaction by index
+ *
+ * @param tx_index - The transaction's index
+ * @returns A view of the stored transaction
+ */
+TransactionView Blockchain::get_transaction ( long tx_index ) {
+	TxLocation location;
+	if ( !( this -> transactions.find ( tx_index, location ) ) )
+		throw std::runtime_error ( "Transaction not found!" );
+
+	return this -> transaction_view ( location );
+}
+
+/**
+ * Gets a view of an indexed transaction without reading the rest of its block
+ *
+ * @param location - The transaction's location
+ * @returns A view of the stored transaction
+ */
+TransactionView Blockchain::transaction_view ( const TxLocation &location ) {
+	serialize::Span block = this -> blocks.bytes ( location.height );
+	return TransactionView ( serialize::Span { block.data + location.offset, location.size } );
+}
+
+/**
+ * Indexes every stored block which hasn't been indexed yet
+ *
+ * @returns The pooled transactions the blocks mined or conflicted with, as they were removed from the mempool
+ */
+std::vector<Transaction> Blockchain::index_blocks () {
+	std::vector<Transaction> removed;
+	for ( ; this -> indexed < this -> blocks.size (); this -> indexed++ ) {
+		std::vector<Transaction> unpooled = this -> connect_block ( this -> indexed );
+		removed.insert ( removed.end (), std::make_move_iterator ( unpooled.begin () ), std::make_move_iterator ( unpooled.end () ) );
+	}
+
+	return removed;
+}
+
+/**
+ * Applies a stored block to the indexes and the UTXO set, recording how to undo it
+ * (The coinbase's input doesn't spend a real output, so only its outputs are
+ * added. Only the last MAX_REORG_DEPTH blocks keep their undo records)
+ *
+ * @param height - The block's position in the chain
+ * @returns The pooled transactions the block mined or conflicted with
+ */
+std::vector<Transaction> Blockchain::connect_block ( size_t height ) {
+	BlockView block = this -> blocks.view ( height );
+	this -> transactions.add_block ( height, block );
+	this -> addresses.add_block ( height, block );
+
+	// Updates the UTXO set before the pool, which looks outputs up while it's locked
+	UndoRecord record;
+	std::unique_lock<std::shared_mutex> lock ( this -> utxo_mutex );
+	for ( TransactionIterator entry = block.begin (); entry != block.end (); ++entry ) {
+		TransactionView transaction = *entry;
+		size_t position = entry.position ();
+
+		if ( position != 0 )
+			for ( size_t x = 0; x < transaction.input_count (); x++ ) {
+				TransactionInputView input = transaction.input ( x );
+				if ( !( this -> utxos.remove ( input.hash () ) ) )
+					throw std::runtime_error ( "Attempted connecting a block which spends a missing output!" );
+
+				record.spent.push_back ( SpentOutput { input.hash (), input.prev_out ().value () } );
+			}
+
+		for ( size_t x = 0; x < transaction.output_count (); x++ ) {
+			TransactionOutputView output = transaction.output ( x );
+			Hash256 outpoint = crypto::sha256 ( output.bytes ().data, output.bytes ().size );
+			this -> utxos.add ( outpoint, output.value () );
+			record.created.push_back ( outpoint );
+		}
+	}
+
+	lock.unlock ();
+	std::vector<Transaction> removed = this -> mempool.remove_block ( block );
+	this -> undo.push_back ( std::move ( record ) );
+	if ( this -> undo.size () > MAX_REORG_DEPTH )
+		this -> undo.pop_front ();
+
+	this -> heights[block.hash ()] = height;
+	this -> chainwork.push_back ( ( height == 0 ? 0 : this -> chainwork[height - 1] ) + block_work ( block.difficulty () ) );
+	this -> snapshots.add_block ( height, block, this -> blocks.pin ( height ), this -> chainwork.back (), this -> addresses );
+	this -> snapshots.publish ();
+	this -> revision++;
+	return removed;
+}
+
+/**
+ * Removes the tip block from the chain, reverting it with its undo record
+ *
+ * @returns The removed block
+ */
+Block Blockchain::disconnect_block () {
+	size_t height = this -> blocks.size () - 1;
+	if ( height == 0 )
+		throw std::runtime_error ( "Attempted disconnecting the genesis block!" );
+
+	if ( this -> undo.empty () )
+		throw std::runtime_error ( "Attempted disconnecting a block below the maximum reorganization depth!" );
+
+	BlockView view = this -> blocks.view ( height );
+	Block block = view.to_block ();
+
+	// Reverts the UTXO set
+	UndoRecord &record = this -> undo.back ();
+	{
+		std::unique_lock<std::shared_mutex> lock ( this -> utxo_mutex );
+		for ( auto outpoint = record.created.rbegin (); outpoint != record.created.rend (); outpoint++ )
+			if ( !( this -> utxos.remove ( *outpoint ) ) )
+				throw std::runtime_error ( "Attempted disconnecting a block whose outputs are spent!" );
+
+		for ( auto &spent : record.spent )
+			this -> utxos.add ( spent.outpoint, spent.value );
+	}
+
+	// Reverts the indexes
+	this -> addresses.remove_block ( height, view );
+	this -> transactions.remove_block ( view );
+	this -> heights.erase ( block.hash );
+	this -> undo.pop_back ();
+	this -> chainwork.pop_back ();
+
+	// Readers of older snapshots may still be reading the block, its bytes stay pinned until they're done
+	this -> snapshots.remove_block ( view, this -> addresses );
+	this -> snapshots.publish ();
+
+	this -> blocks.pop_back ();
+	this -> indexed--;
+	this -> revision++;
+	return block;
+}
+
+/**
+ * Gets a key's confirmed balance
+ *
+ * @param key - The public key's PEM
+ * @returns The balance
+ */
+long Blockchain::get_balance ( const std::string &key ) {
+	return this -> addresses.balance ( AddressIndex::address ( key ) );
+}
+
+/**
+ * Gets a page of the mined outputs a key appears in, oldest first
+ *
+ * @param key - The public key's PEM
+ * @param offset - The number of outputs to skip
+ * @param count - The maximum number of outputs to return
+ * @returns The outputs' references
+ */
+std::vector<OutputRef> Blockchain::get_history ( const std::string &key, size_t offset, size_t count ) {
+	return this -> addresses.history ( AddressIndex::address ( key ), offset, count );
+}
+
+/**
+ * Submits a copy of a transaction to the mempool, to be mined with the next block
+ *
+ * @param transaction - The transaction
+ */
+void Blockchain::add_transaction ( const Transaction &transaction ) {
+	this -> add_transaction ( Transaction ( transaction ) );
+}
+
+/**
+ * Submits a transaction to the mempool, to be mined with the next block
+ * (Safe to call while a block is being mined, from any number of threads)
+ *
+ * @param transaction - The transaction
+ */
+void Blockchain::add_transaction ( Transaction &&transaction ) {
+	if ( !( this -> mempool.add ( std::move ( transaction ) ) ) )
+		throw std::runtime_error ( "Attempted adding a transaction with too low a priority for the mempool!" );
+}
+
+/**
+ * Submits a batch of transactions to the mempool
+ * (Verified in parallel on the chain's threads; a rejected transaction is
+ * reported in its own result instead of failing the rest of the batch)
+ *
+ * @param transactions - The transactions
+ * @returns The outcome of each submission, in the same order
+ */
+std::vector<SubmitResult> Blockchain::add_transactions ( std::vector<Transaction> transactions ) {
+	return this -> mempool.add_many ( transactions, this -> threads );
 }
 
 /**
@@ -35,11 +751,11 @@ void Blockchain::add_transaction ( Transaction transaction ) {
  * @param coinbase - The coinbase which should be validated
  * @returns Whether or not the given coinbase is valid
  */
-bool Blockchain::verify_coinbase ( Transaction coinbase ) {
+bool Blockchain::verify_coinbase ( Transaction &coinbase ) {
 
 	// Verifies the coinbase input total
 	long total = 0;
-	for ( auto input : coinbase.inputs )
+	for ( auto &input : coinbase.inputs )
 		total += input.prev_out.value;
 
 	if ( this -> reward != total )
@@ -63,23 +779,45 @@ void Blockchain::create_genesis_block ( Transaction coinbase ) {
 		throw std::runtime_error ( "Attempted to create genesis block with invalid coinbase transaction!" ); 
 
 	// Creates a new block
-	Block genesis_block ( "genesis", 0, difficulty );
-	genesis_block.set_coinbase ( coinbase );
-	genesis_block.mine_block ();
+	Block genesis_block ( Hash256 {}, 0, difficulty );
+	genesis_block.set_coinbase ( std::move ( coinbase ) );
+	genesis_block.mine_block ( this -> threads );
 
-	this -> blocks.push_back ( genesis_block );
+	this -> blocks.append ( genesis_block );
+	this -> index_blocks ();
 }
 
 /**
  * Creates a new empty block
- *
- * @param coinbase - The new block's coinbase
  */
 void Blockchain::create_block () {
 
 	// Creates a new block
-	Block current_block ( this -> blocks.back ().hash, ( this -> blocks.back ().index ) + ( this -> blocks.back ().transactions.size () ), this -> difficulty );
-	this -> current_block = current_block;
+	const BlockHeader &tip = this -> blocks.back ();
+	this -> current_block = Block ( tip.hash, tip.index + tip.transactions, this -> difficulty );
+	this -> pending_spends.clear ();
+}
+
+/**
+ * Adds transactions to a block, highest priority first
+ * (Transactions whose inputs have been spent since they were submitted are
+ * dropped, the rest are verified and added as one batch)
+ *
+ * @param block - The block
+ * @param transactions - The transactions, as picked from the mempool
+ * @param spends - The outputs already spent by the block (recieves the added transactions' spends)
+ */
+void Blockchain::fill_block ( Block &block, std::vector<Transaction> transactions, std::unordered_map<Hash256, uint32_t> &spends ) {
+	std::vector<Transaction> available;
+	for ( auto &transaction : transactions )
+		if ( this -> verify_inputs ( transaction, spends ) )
+			available.push_back ( std::move ( transaction ) );
+
+	std::vector<bool> added = block.add_transactions ( available, this -> threads );
+	for ( size_t x = 0; x < available.size (); x++ )
+		if ( !( added[x] ) )
+			for ( auto &input : available[x].inputs )
+				spends[input.hash]--;
 }
 
 /**
@@ -88,10 +826,11 @@ void Blockchain::create_block () {
 void Blockchain::insert_block () {
 
 	// Verifies the current block
-	if ( !( this -> current_block.verify ( false, this -> reward ) ) )
+	if ( !( this -> current_block.verify ( false, this -> reward, this -> threads ) ) || !( this -> verify_inputs ( this -> current_block ) ) )
 		throw std::runtime_error ( "Attempted pushing invalid block!" );
 
-	this -> blocks.push_back ( this -> current_block );
+	this -> blocks.append ( this -> current_block );
+	this -> index_blocks ();
 
 	// Creates a new block
 	this -> create_block ();
@@ -123,10 +862,10 @@ void Blockchain::print () {
 	this -> current_block.print ( false );
 
 	// Prints the genesis block
-	this -> blocks.front ().print ( true );
+	this -> blocks.get_block ( 0 ).print ( true );
 
 	// Print the blocks
-	for ( std::vector<Block>::iterator block = this -> blocks.begin () + 1; block != this -> blocks.end (); block++ )
-		block -> print ( false );
+	for ( size_t height = 1; height < this -> blocks.size (); height++ )
+		this -> blocks.get_block ( height ).print ( false );
 
 }
\ No newline at end of file
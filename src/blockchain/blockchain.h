@@ -3,32 +3,105 @@
 #define BLOCKCHAIN_H
 
 #include <vector>
+#include <deque>
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
 #include <iostream>
+#include <thread>
+#include <cmath>
+#include <unordered_map>
 #include "block.h"
+#include "block_store.h"
+#include "tx_index.h"
+#include "address_index.h"
+#include "utxo_set.h"
+#include "mempool.h"
+#include "chain_snapshot.h"
 #include "transaction.h"
 
 class Blockchain {
 	public: 
+		static const size_t BLOCK_ASSEMBLY_BYTES = 1 << 20;
+		static const size_t MAX_REORG_DEPTH = 100;
+
 		Block current_block;
-		std::vector<Block> blocks;
+		BlockStore blocks;
 		long reward;
 		int difficulty;
+		unsigned int threads;
+		Hash256 assume_valid;
+		TxIndex transactions;
+		AddressIndex addresses;
+		UtxoSet utxos;
+		Mempool mempool;
 
 		Blockchain ( int difficulty, long reward, Transaction coinbase );
+		Blockchain ( int difficulty, long reward, Transaction coinbase, unsigned int threads );
+		Blockchain ( int difficulty, long reward, Transaction coinbase, unsigned int threads, std::string path );
+		Blockchain ( std::string path, int difficulty, long reward, unsigned int threads );
+		Blockchain ( std::string path, int difficulty, long reward, unsigned int threads, Hash256 assume_valid );
+		Blockchain ( Block genesis, int difficulty, long reward, unsigned int threads );
 
 		void mine_block ( Transaction coinbase );
+		Block create_template ( Transaction coinbase );
+		uint64_t get_revision ();
+		bool accept_block ( Block block );
+		bool accept_block ( Block block, bool is_verified );
+		double get_chainwork ();
+		static double block_work ( int difficulty );
+		std::shared_ptr<const ChainSnapshot> snapshot ();
+		Block get_block ( size_t height );
+		size_t height ();
+		bool verify_chain ();
+
+		bool has_transaction ( const Hash256 &hash );
+		TransactionView get_transaction ( const Hash256 &hash );
+		TransactionView get_transaction ( long tx_index );
+
+		long get_balance ( const std::string &key );
+		std::vector<OutputRef> get_history ( const std::string &key, size_t offset, size_t count );
 
-		void add_transaction ( Transaction transaction );
+		void add_transaction ( const Transaction &transaction );
+		void add_transaction ( Transaction &&transaction );
+		std::vector<SubmitResult> add_transactions ( std::vector<Transaction> transactions );
 
 		void print ();
 
 	private:
-		bool verify_coinbase ( Transaction coinbase );
+		struct SideBlock {
+			Block block;
+			double chainwork;
+			size_t height;
+		};
+
+		size_t indexed;
+		std::unordered_map<Hash256, uint32_t> pending_spends;
+		std::unordered_map<Hash256, size_t> heights;
+		std::vector<double> chainwork;
+		std::deque<UndoRecord> undo;
+		std::unordered_map<Hash256, SideBlock> side_blocks;
+		std::atomic<uint64_t> revision;
+		std::shared_mutex utxo_mutex;
+		SnapshotPublisher snapshots;
+
+		bool verify_coinbase ( Transaction &coinbase );
 
 		void create_genesis_block ( Transaction coinbase );
 		void create_block ();
+		void fill_block ( Block &block, std::vector<Transaction> transactions, std::unordered_map<Hash256, uint32_t> &spends );
 
 		void insert_block ();
+		std::vector<Transaction> index_blocks ();
+		std::vector<Transaction> connect_block ( size_t height );
+		Block disconnect_block ();
+		void reorganize ( const Hash256 &tip );
+		void restore_transactions ( std::vector<Transaction> transactions );
+		void prune_side_blocks ();
+		bool verify_inputs ( Block &block );
+		bool verify_inputs ( Transaction &transaction, std::unordered_map<Hash256, uint32_t> &spends );
+		bool find_output ( const Hash256 &outpoint, int64_t &value );
+		TransactionView transaction_view ( const TxLocation &location );
 
 };
 
@@ -0,0 +1,254 @@
+#include "chain_snapshot.h"
+
+/**
+ * The snapshot constructor (creates an empty chain)
+ */
+ChainSnapshot::ChainSnapshot () {
+	this -> count = 0;
+}
+
+/**
+ * Gets the number of blocks in the snapshot
+ *
+ * @returns The chain's height at the snapshot
+ */
+size_t ChainSnapshot::size () const {
+	return this -> count;
+}
+
+bool ChainSnapshot::empty () const {
+	return this -> count == 0;
+}
+
+const BlockHeader &ChainSnapshot::header ( size_t height ) const {
+	return this -> entry ( height ).header;
+}
+
+const BlockHeader &ChainSnapshot::back () const {
+	if ( this -> count == 0 )
+		throw std::runtime_error ( "Attempted reading a block outside the snapshot!" );
+
+	return this -> entry ( this -> count - 1 ).header;
+}
+
+/**
+ * Gets the total work of the snapshot's chain
+ *
+ * @returns The tip's chainwork
+ */
+double ChainSnapshot::get_chainwork () const {
+	return this -> count == 0 ? 0 : this -> entry ( this -> count - 1 ).chainwork;
+}
+
+/**
+ * Gets a block's encoding, straight out of the store's memory map
+ *
+ * @param height - The block's position in the chain
+ * @returns The bytes, which stay valid for as long as the snapshot is held
+ */
+serialize::Span ChainSnapshot::bytes ( size_t height ) const {
+	return this -> entry ( height ).bytes;
+}
+
+BlockView ChainSnapshot::view ( size_t height ) const {
+	return BlockView ( this -> bytes ( height ) );
+}
+
+Block ChainSnapshot::get_block ( size_t height ) const {
+	return this -> view ( height ).to_block ();
+}
+
+/**
+ * Gets a key's confirmed balance at the snapshot
+ *
+ * @param key - The public key's PEM
+ * @returns The balance
+ */
+long ChainSnapshot::get_balance ( const std::string &key ) const {
+	long balance = 0;
+	this -> balances.find ( AddressIndex::address ( key ), balance );
+	return balance;
+}
+
+bool ChainSnapshot::has_transaction ( const Hash256 &hash ) const {
+	TxLocation location;
+	return this -> transactions.find ( hash, location );
+}
+
+/**
+ * Finds a mined transaction by hash
+ *
+ * @param hash - The transaction's hash
+ * @returns A view of the stored transaction
+ */
+TransactionView ChainSnapshot::get_transaction ( const Hash256 &hash ) const {
+	TxLocation location;
+	if ( !( this -> transactions.find ( hash, location ) ) )
+		throw std::runtime_error ( "Transaction not found!" );
+
+	serialize::Span block = this -> bytes ( location.height );
+	return TransactionView ( serialize::Span { block.data + location.offset, location.size } );
+}
+
+/**
+ * Finds a mined transaction by index, binary searching the headers
+ *
+ * @param tx_index - The transaction's index
+ * @returns A view of the stored transaction
+ */
+TransactionView ChainSnapshot::get_transaction ( long tx_index ) const {
+	size_t begin = 0;
+	size_t end = this -> count;
+	while ( begin < end ) {
+		size_t middle = begin + ( end - begin ) / 2;
+		const BlockHeader &header = this -> header ( middle );
+
+		if ( tx_index < header.index )
+			end = middle;
+		else if ( tx_index - header.index >= (long) header.transactions )
+			begin = middle + 1;
+		else
+			return this -> view ( middle ).transaction ( tx_index - header.index );
+	}
+
+	throw std::runtime_error ( "Transaction not found!" );
+}
+
+/**
+ * Prints every block in the snapshot
+ */
+void ChainSnapshot::print () const {
+	for ( size_t height = 0; height < this -> count; height++ )
+		this -> get_block ( height ).print ( height == 0 );
+}
+
+const ChainSnapshot::Entry &ChainSnapshot::entry ( size_t height ) const {
+	if ( height >= this -> count )
+		throw std::runtime_error ( "Attempted reading a block outside the snapshot!" );
+
+	return this -> chunks[height / CHUNK_SIZE] -> entries[height % CHUNK_SIZE];
+}
+
+/**
+ * The publisher constructor (publishes an empty chain)
+ */
+SnapshotPublisher::SnapshotPublisher () {
+	this -> count = 0;
+	this -> published = std::make_shared<const ChainSnapshot> ();
+}
+
+/**
+ * Gets the most recently published snapshot
+ * (Safe to call from any thread)
+ *
+ * @returns The snapshot
+ */
+std::shared_ptr<const ChainSnapshot> SnapshotPublisher::current () const {
+	return std::atomic_load ( &this -> published );
+}
+
+/**
+ * Adds a connected block to the next snapshot
+ * (The block's entry goes into the first slot past the published snapshot's
+ * end, which no reader looks at)
+ *
+ * @param height - The block's position in the chain
+ * @param block - A view of the stored block
+ * @param pin - The block's pin in the store
+ * @param chainwork - The chain's total work up to the block
+ * @param addresses - The address index, which already includes the block
+ */
+void SnapshotPublisher::add_block ( size_t height, BlockView block, std::shared_ptr<const void> pin, double chainwork, const AddressIndex &addresses ) {
+	if ( height != this -> count )
+		throw std::runtime_error ( "Attempted adding a block to a snapshot out of order!" );
+
+	if ( height % ChainSnapshot::CHUNK_SIZE == 0 && height / ChainSnapshot::CHUNK_SIZE == this -> chunks.size () )
+		this -> chunks.push_back ( std::make_shared<ChainSnapshot::Chunk> () );
+
+	BlockHeader header { block.hash (), block.prev_block (), block.index (), block.transaction_count (), BlockLocation {} };
+	this -> chunks[height / ChainSnapshot::CHUNK_SIZE] -> entries[height % ChainSnapshot::CHUNK_SIZE] = ChainSnapshot::Entry { header, block.bytes (), std::move ( pin ), chainwork };
+	this -> count++;
+
+	for ( TransactionIterator entry = block.begin (); entry != block.end (); ++entry ) {
+		TransactionView transaction = *entry;
+		size_t position = entry.position ();
+		uint32_t offset = (uint32_t) ( transaction.bytes ().data - block.bytes ().data );
+		this -> transactions = this -> transactions.set ( transaction.hash (), TxLocation { (uint32_t) height, (uint32_t) position, offset, (uint32_t) transaction.bytes ().size } );
+	}
+
+	this -> update_balances ( block, addresses );
+}
+
+/**
+ * Removes the tip block from the next snapshot
+ * (Published snapshots may still read the block's slot, so its chunk is
+ * copied before the slot is cleared, and the next block added goes into the copy)
+ *
+ * @param block - A view of the stored block
+ * @param addresses - The address index, which no longer includes the block
+ */
+void SnapshotPublisher::remove_block ( BlockView block, const AddressIndex &addresses ) {
+	if ( this -> count == 0 )
+		throw std::runtime_error ( "Attempted removing a block from an empty snapshot!" );
+
+	this -> count--;
+
+	std::shared_ptr<ChainSnapshot::Chunk> &chunk = this -> chunks[this -> count / ChainSnapshot::CHUNK_SIZE];
+	chunk = std::make_shared<ChainSnapshot::Chunk> ( *chunk );
+	chunk -> entries[this -> count % ChainSnapshot::CHUNK_SIZE] = ChainSnapshot::Entry {};
+
+	for ( TransactionView transaction : block )
+		this -> transactions = this -> transactions.erase ( transaction.hash () );
+
+	this -> update_balances ( block, addresses );
+}
+
+/**
+ * Empties the next snapshot
+ * (The chunks aren't reused, so published snapshots keep theirs)
+ */
+void SnapshotPublisher::clear () {
+	this -> chunks.clear ();
+	this -> count = 0;
+	this -> balances = HashTrie<long> ();
+	this -> transactions = HashTrie<TxLocation> ();
+}
+
+/**
+ * Publishes the blocks added and removed since the last snapshot
+ */
+void SnapshotPublisher::publish () {
+	auto snapshot = std::make_shared<ChainSnapshot> ();
+	snapshot -> chunks.assign ( this -> chunks.begin (), this -> chunks.end () );
+	snapshot -> count = this -> count;
+	snapshot -> balances = this -> balances;
+	snapshot -> transactions = this -> transactions;
+
+	std::atomic_store ( &this -> published, std::shared_ptr<const ChainSnapshot> ( std::move ( snapshot ) ) );
+}
+
+/**
+ * Copies the balances a block changed from the address index
+ *
+ * @param block - A view of the stored block
+ * @param addresses - The address index
+ */
+void SnapshotPublisher::update_balances ( BlockView block, const AddressIndex &addresses ) {
+	std::unordered_set<Hash256> changed;
+	for ( TransactionIterator entry = block.begin (); entry != block.end (); ++entry ) {
+		TransactionView transaction = *entry;
+		size_t position = entry.position ();
+
+		if ( position != 0 )
+			for ( size_t x = 0; x < transaction.input_count (); x++ )
+				changed.insert ( transaction.input ( x ).prev_out ().recipient () );
+
+		for ( size_t x = 0; x < transaction.output_count (); x++ )
+			changed.insert ( transaction.output ( x ).recipient () );
+	}
+
+	for ( auto &address : changed ) {
+		long balance = addresses.balance ( address );
+		this -> balances = balance == 0 ? this -> balances.erase ( address ) : this -> balances.set ( address, balance );
+	}
+}
@@ -0,0 +1,104 @@
+#pragma once
+#ifndef CHAIN_SNAPSHOT_H
+#define CHAIN_SNAPSHOT_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <unordered_set>
+#include "block.h"
+#include "views.h"
+#include "block_store.h"
+#include "tx_index.h"
+#include "address_index.h"
+#include "algorithms/hash256.h"
+#include "algorithms/hash_trie.h"
+#include "algorithms/serialize.h"
+
+/**
+ * An immutable view of the active chain at one tip
+ * (Safe to read from any number of threads while the chain keeps growing.
+ * Headers live in fixed size chunks which are shared between snapshots and
+ * only ever written past the end of every published snapshot; balances and
+ * transaction hashes live in path copied tries. Block bytes are read straight
+ * from the store's memory maps, each entry holds its block's pin so removed
+ * blocks stay readable)
+ */
+class ChainSnapshot {
+	public:
+		static const size_t CHUNK_SIZE = 1024;
+
+		struct Entry {
+			BlockHeader header;
+			serialize::Span bytes;
+			std::shared_ptr<const void> pin;
+			double chainwork;
+		};
+
+		struct Chunk {
+			Entry entries[CHUNK_SIZE];
+		};
+
+		ChainSnapshot ();
+
+		size_t size () const;
+		bool empty () const;
+		const BlockHeader &header ( size_t height ) const;
+		const BlockHeader &back () const;
+		double get_chainwork () const;
+
+		serialize::Span bytes ( size_t height ) const;
+		BlockView view ( size_t height ) const;
+		Block get_block ( size_t height ) const;
+
+		long get_balance ( const std::string &key ) const;
+		bool has_transaction ( const Hash256 &hash ) const;
+		TransactionView get_transaction ( const Hash256 &hash ) const;
+		TransactionView get_transaction ( long tx_index ) const;
+
+		void print () const;
+
+	private:
+		friend class SnapshotPublisher;
+
+		std::vector<std::shared_ptr<const Chunk>> chunks;
+		size_t count;
+		HashTrie<long> balances;
+		HashTrie<TxLocation> transactions;
+
+		const Entry &entry ( size_t height ) const;
+};
+
+/**
+ * Builds and publishes the active chain's snapshots, RCU style
+ * (Only the thread which owns the chain may update the publisher; readers
+ * load the current snapshot without ever blocking it, and it never waits for
+ * them. Reclamation is deferred: removing a block copies its chunk, so the
+ * slot can be reused without touching what older snapshots see, and the
+ * block's bytes stay pinned until the last snapshot holding them is released)
+ */
+class SnapshotPublisher {
+	public:
+		SnapshotPublisher ();
+
+		std::shared_ptr<const ChainSnapshot> current () const;
+
+		void add_block ( size_t height, BlockView block, std::shared_ptr<const void> pin, double chainwork, const AddressIndex &addresses );
+		void remove_block ( BlockView block, const AddressIndex &addresses );
+		void clear ();
+
+		void publish ();
+
+	private:
+		std::shared_ptr<const ChainSnapshot> published;
+
+		std::vector<std::shared_ptr<ChainSnapshot::Chunk>> chunks;
+		size_t count;
+		HashTrie<long> balances;
+		HashTrie<TxLocation> transactions;
+
+		void update_balances ( BlockView block, const AddressIndex &addresses );
+};
+
+#endif
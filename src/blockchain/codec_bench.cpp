@@ -0,0 +1,76 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <string>
+#include <cstdlib>
+#include <algorithm>
+#include "wallet.h"
+#include "views.h"
+#include "block.h"
+#include "blockchain.h"
+#include "transaction.h"
+
+/**
+ * Times a callable, averaged over several runs
+ *
+ * @param runs - The number of runs
+ * @param run - The callable
+ * @returns The mean time of one run in milliseconds
+ */
+template <typename Run>
+static double measure ( int runs, Run run ) {
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now ();
+	for ( int x = 0; x < runs; x++ )
+		run ();
+
+	return std::chrono::duration<double, std::milli> ( std::chrono::steady_clock::now () - start ).count () / runs;
+}
+
+/**
+ * Benchmarks encoding, decoding and walking blocks of a growing number of transactions
+ * (Run with a number to scale the iteration counts, e.g. codec_bench 10)
+ */
+int main ( int argc, char **argv ) {
+	int scale = argc > 1 ? std::max ( std::atoi ( argv[1] ), 1 ) : 1;
+
+	// Signs one transaction, which every block repeats
+	Wallet walletA ( crypto::SignatureScheme::ed25519 () );
+	Wallet walletB ( crypto::SignatureScheme::ed25519 () );
+	Blockchain chain ( 1, 69, walletA.create_coinbase ( walletA.public_key, 69 ), 1 );
+	walletA.sync ( chain );
+	Transaction transaction = walletA.create_transaction ( walletB.public_key, 1 );
+
+	std::cout << std::setw ( 8 ) << "txs" << std::setw ( 10 ) << "bytes" << std::setw ( 14 ) << "encode MB/s" << std::setw ( 14 ) << "decode MB/s" << std::setw ( 12 ) << "view MB/s" << std::setw ( 14 ) << "iterate (ms)" << std::setw ( 14 ) << "indexed (ms)" << std::endl;
+	for ( size_t count : { 10, 100, 1000, 5000 } ) {
+		Block block ( Hash256 {}, 0, 1 );
+		block.set_coinbase ( walletA.create_coinbase ( walletA.public_key, 69 ) );
+		std::vector<Transaction> transactions ( count, transaction );
+		block.add_transactions ( transactions, 1 );
+
+		int runs = std::max<int> ( 1, 20000 / (int) count ) * scale;
+		std::string bytes = block.to_bytes ();
+		serialize::Span span { reinterpret_cast<const unsigned char*> ( bytes.data () ), bytes.size () };
+		double megabytes = bytes.size () / 1e6;
+
+		std::string output;
+		double encode = measure ( runs, [&] () { output = block.to_bytes (); } );
+		double decode = measure ( runs, [&] () { Block::decode ( span ); } );
+		double view = measure ( runs, [&] () { BlockView parsed ( span ); } );
+
+		// Hashes every transaction straight from the encoding, in one pass and position by position
+		BlockView encoded ( span );
+		Hash256 last;
+		double iterate = measure ( runs, [&] () {
+			for ( TransactionView transaction : encoded )
+				last = transaction.hash ();
+		} );
+
+		double indexed = measure ( std::max ( 1, runs / 10 ), [&] () {
+			for ( size_t position = 0; position < encoded.transaction_count (); position++ )
+				last = encoded.transaction ( position ).hash ();
+		} );
+
+		std::cout << std::fixed << std::setprecision ( 1 ) << std::setw ( 8 ) << count << std::setw ( 10 ) << bytes.size () << std::setw ( 14 ) << megabytes / encode * 1000 << std::setw ( 14 ) << megabytes / decode * 1000 << std::setw ( 12 ) << megabytes / view * 1000 << std::setprecision ( 3 ) << std::setw ( 14 ) << iterate << std::setw ( 14 ) << indexed << std::endl;
+	}
+}
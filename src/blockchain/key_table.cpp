@@ -0,0 +1,256 @@
+#include "key_table.h"
+
+/**
+ * The key table constructor
+ * (Reserves the NONE handle)
+ */
+KeyTable::KeyTable (): keys ( KEY_CACHE_SIZE ) {
+	this -> entries.push_back ( Entry {} );
+	this -> handles[Hash256 {}] = NONE;
+}
+
+/**
+ * Gets the table shared by every output in the process
+ *
+ * @returns The key table
+ */
+KeyTable &KeyTable::global () {
+	static KeyTable table;
+	return table;
+}
+
+/**
+ * Gets a public key's ID
+ *
+ * @param pem - The public key's PEM
+ * @returns The SHA256 of the PEM
+ */
+Hash256 KeyTable::key_id ( const std::string &pem ) {
+	return crypto::sha256 ( reinterpret_cast<const unsigned char*> ( pem.data () ), pem.size () );
+}
+
+/**
+ * Interns a public key
+ *
+ * @param pem - The public key's PEM (empty for NONE)
+ * @returns The key's handle
+ */
+KeyTable::Handle KeyTable::intern ( const std::string &pem ) {
+	if ( pem.empty () )
+		return NONE;
+
+	Hash256 id = key_id ( pem );
+	std::unique_lock<std::shared_mutex> lock ( this -> mutex );
+
+	Handle handle = this -> insert ( id );
+	Entry &entry = this -> entry ( handle );
+	if ( entry.pem.empty () )
+		entry.pem = pem;
+
+	return handle;
+}
+
+/**
+ * Interns a key ID whose PEM may not be known yet
+ *
+ * @param id - The key's ID (all zeros for NONE)
+ * @returns The key's handle
+ */
+KeyTable::Handle KeyTable::intern ( const Hash256 &id ) {
+	{
+		std::shared_lock<std::shared_mutex> lock ( this -> mutex );
+		auto handle = this -> handles.find ( id );
+		if ( handle != this -> handles.end () )
+			return handle -> second;
+	}
+
+	std::unique_lock<std::shared_mutex> lock ( this -> mutex );
+	return this -> insert ( id );
+}
+
+/**
+ * Gets a key's ID
+ *
+ * @param handle - The key's handle
+ * @returns The key's ID
+ */
+Hash256 KeyTable::id ( Handle handle ) {
+	std::shared_lock<std::shared_mutex> lock ( this -> mutex );
+	return this -> entry ( handle ).id;
+}
+
+/**
+ * Checks whether a key's PEM is known
+ *
+ * @param handle - The key's handle
+ * @returns Whether or not the PEM has been interned, or is shipped by a live scope
+ */
+bool KeyTable::has_pem ( Handle handle ) {
+	std::shared_lock<std::shared_mutex> lock ( this -> mutex );
+	return !( this -> find_pem ( this -> entry ( handle ) ).empty () );
+}
+
+/**
+ * Gets a key's PEM
+ *
+ * @param handle - The key's handle
+ * @returns The PEM (empty if it isn't known)
+ */
+std::string KeyTable::pem ( Handle handle ) {
+	std::shared_lock<std::shared_mutex> lock ( this -> mutex );
+	return this -> find_pem ( this -> entry ( handle ) );
+}
+
+/**
+ * Gets a key as an EVP_PKEY
+ * (Parsed keys are cached by key ID, only the KEY_CACHE_SIZE most recently used are kept)
+ *
+ * @param handle - The key's handle
+ * @returns The public key (empty if the PEM is unknown or invalid)
+ */
+std::shared_ptr<EVP_PKEY> KeyTable::key ( Handle handle ) {
+	Hash256 id;
+	std::string pem;
+	{
+		std::shared_lock<std::shared_mutex> lock ( this -> mutex );
+		Entry &entry = this -> entry ( handle );
+		id = entry.id;
+		pem = this -> find_pem ( entry );
+	}
+
+	std::shared_ptr<EVP_PKEY> key;
+	if ( pem.empty () || this -> keys.get ( id, key ) )
+		return key;
+
+	// Parses the PEM outside the lock
+	BIO *bio = BIO_new_mem_buf ( pem.c_str (), pem.length () );
+	if ( !bio )
+		return key;
+
+	key = std::shared_ptr<EVP_PKEY> ( PEM_read_bio_PUBKEY ( bio, NULL, NULL, NULL ), EVP_PKEY_free );
+	BIO_free ( bio );
+
+	if ( key )
+		this -> keys.put ( id, key );
+
+	return key;
+}
+
+size_t KeyTable::size () {
+	std::shared_lock<std::shared_mutex> lock ( this -> mutex );
+	return this -> entries.size () - 1;
+}
+
+/**
+ * Gets a handle's entry, the caller must hold the lock
+ *
+ * @param handle - The key's handle
+ * @returns The entry
+ */
+KeyTable::Entry &KeyTable::entry ( Handle handle ) {
+	if ( handle >= this -> entries.size () )
+		throw std::runtime_error ( "Attempted reading an unknown key handle!" );
+
+	return this -> entries[handle];
+}
+
+/**
+ * Gets an entry's PEM, falling back on the PEMs shipped by live scopes, the caller must hold the lock
+ *
+ * @param entry - The key's entry
+ * @returns The PEM (empty if it isn't known)
+ */
+std::string KeyTable::find_pem ( const Entry &entry ) {
+	if ( !( entry.pem.empty () ) )
+		return entry.pem;
+
+	auto shipped = this -> shipped.find ( entry.id );
+	return shipped == this -> shipped.end () ? std::string () : shipped -> second.pem;
+}
+
+/**
+ * Adds a key ID if it isn't in the table yet, the caller must hold the unique lock
+ *
+ * @param id - The key's ID
+ * @returns The key's handle
+ */
+KeyTable::Handle KeyTable::insert ( const Hash256 &id ) {
+	auto handle = this -> handles.find ( id );
+	if ( handle != this -> handles.end () )
+		return handle -> second;
+
+	Handle next = (Handle) this -> entries.size ();
+	this -> entries.push_back ( Entry { id, "" } );
+	this -> handles[id] = next;
+	return next;
+}
+
+/**
+ * The scope constructor
+ *
+ * @param table - The table the scope's PEMs are read through
+ */
+KeyTable::Scope::Scope ( KeyTable &table ): table ( table ) {}
+
+/**
+ * The scope destructor
+ * (Forgets every PEM which no other scope ships and which wasn't interned)
+ */
+KeyTable::Scope::~Scope () {
+	this -> release ();
+}
+
+/**
+ * Ships a PEM with the scope
+ * (PEMs the table already knows aren't kept)
+ *
+ * @param pem - The public key's PEM
+ */
+void KeyTable::Scope::add ( const std::string &pem ) {
+	if ( pem.empty () )
+		return;
+
+	Hash256 id = key_id ( pem );
+	std::unique_lock<std::shared_mutex> lock ( this -> table.mutex );
+
+	auto handle = this -> table.handles.find ( id );
+	if ( handle != this -> table.handles.end () && !( this -> table.entries[handle -> second].pem.empty () ) )
+		return;
+
+	Shipped &shipped = this -> table.shipped.emplace ( id, Shipped { pem, 0 } ).first -> second;
+	shipped.scopes++;
+	this -> ids.push_back ( id );
+}
+
+/**
+ * Interns every PEM shipped with the scope, once what shipped them has been validated
+ */
+void KeyTable::Scope::intern () {
+	{
+		std::unique_lock<std::shared_mutex> lock ( this -> table.mutex );
+		for ( auto &id : this -> ids ) {
+			Entry &entry = this -> table.entry ( this -> table.insert ( id ) );
+			if ( entry.pem.empty () )
+				entry.pem = this -> table.shipped.at ( id ).pem;
+		}
+	}
+
+	this -> release ();
+}
+
+/**
+ * Stops shipping the scope's PEMs
+ */
+void KeyTable::Scope::release () {
+	if ( this -> ids.empty () )
+		return;
+
+	std::unique_lock<std::shared_mutex> lock ( this -> table.mutex );
+	for ( auto &id : this -> ids ) {
+		auto shipped = this -> table.shipped.find ( id );
+		if ( --shipped -> second.scopes == 0 )
+			this -> table.shipped.erase ( shipped );
+	}
+
+	this -> ids.clear ();
+}
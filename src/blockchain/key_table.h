@@ -0,0 +1,98 @@
+#pragma once
+#ifndef KEY_TABLE_H
+#define KEY_TABLE_H
+
+#include <deque>
+#include <mutex>
+#include <memory>
+#include <string>
+#include <cstdint>
+#include <shared_mutex>
+#include <vector>
+#include <unordered_map>
+#include <openssl/evp.h>
+#include <openssl/bio.h>
+#include <openssl/pem.h>
+#include "algorithms/crypto.h"
+#include "algorithms/hash256.h"
+#include "algorithms/lru_cache.h"
+
+/**
+ * The process-wide table of public keys
+ * (Every distinct key is stored once and referenced by a small handle in
+ * memory, or by its key ID, the SHA256 of its PEM, once encoded. A key ID
+ * can be interned before its PEM is known, e.g. while decoding a block
+ * whose keys come after its transactions. Parsed keys are kept in a bounded
+ * cache rather than with their entries)
+ */
+class KeyTable {
+	public:
+		typedef uint32_t Handle;
+
+		static const size_t KEY_CACHE_SIZE = 4096;
+
+		// The handle of the missing key (a coinbase input's author), whose ID is all zeros
+		static const Handle NONE = 0;
+
+		static KeyTable &global ();
+		static Hash256 key_id ( const std::string &pem );
+
+		Handle intern ( const std::string &pem );
+		Handle intern ( const Hash256 &id );
+
+		Hash256 id ( Handle handle );
+		bool has_pem ( Handle handle );
+		std::string pem ( Handle handle );
+		std::shared_ptr<EVP_PKEY> key ( Handle handle );
+		size_t size ();
+
+		/**
+		 * The PEMs shipped with something which hasn't been validated yet, e.g. a decoded block
+		 * (They can be read through the table while the scope lives, and are
+		 * only added to it for good once the scope is interned)
+		 */
+		class Scope {
+			public:
+				Scope ( KeyTable &table );
+				~Scope ();
+
+				void add ( const std::string &pem );
+				void intern ();
+
+			private:
+				KeyTable &table;
+				std::vector<Hash256> ids;
+
+				Scope ( const Scope & ) = delete;
+				Scope &operator= ( const Scope & ) = delete;
+
+				void release ();
+		};
+
+	private:
+		struct Entry {
+			Hash256 id;
+			std::string pem;
+		};
+
+		struct Shipped {
+			std::string pem;
+			size_t scopes;
+		};
+
+		std::shared_mutex mutex;
+		std::deque<Entry> entries;
+		std::unordered_map<Hash256, Handle> handles;
+		std::unordered_map<Hash256, Shipped> shipped;
+		LruCache<Hash256, std::shared_ptr<EVP_PKEY>> keys;
+
+		KeyTable ();
+		KeyTable ( const KeyTable & ) = delete;
+		KeyTable &operator= ( const KeyTable & ) = delete;
+
+		Entry &entry ( Handle handle );
+		std::string find_pem ( const Entry &entry );
+		Handle insert ( const Hash256 &id );
+};
+
+#endif
@@ -7,36 +7,42 @@
 int main () {
 
 	// Creates the wallets
-	Wallet walletA ( 1024 );
-	Wallet walletB ( 1024 );
-
-	// Creates a new coinbase
-	Transaction coinbase = walletA.create_coinbase ( walletA.public_key, 69 );
-
-
-	Transaction test = walletA.create_transaction ( walletB.public_key, 2 );
-
-	// Creates a new blockchain
-	Blockchain chain ( 2, 69, coinbase );
+	Wallet walletA ( crypto::SignatureScheme::ed25519 () );
+	Wallet walletB ( crypto::SignatureScheme::ed25519 () );
 
+	// Creates a new blockchain, paying the genesis reward to wallet A
+	Blockchain chain ( 2, 69, walletA.create_coinbase ( walletA.public_key, 69 ) );
+	Hash256 test;
 	for ( int x = 0; x < 3; x++ ) {
-		Transaction y = walletA.create_coinbase ( walletA.public_key, 69 );
-
-		Transaction a = walletA.create_transaction ( walletB.public_key, 1 );
-		Transaction b = walletA.create_transaction ( walletB.public_key, 1 );
-		Transaction c = walletA.create_transaction ( walletB.public_key, 1 );
+		walletA.sync ( chain );
+		walletB.sync ( chain );
 
-		chain.add_transaction ( a );
-		chain.add_transaction ( b );
-		chain.add_transaction ( c );
+		// Wallet A pays wallet B, and wallet B pays some of it back once it's been mined
+		chain.add_transaction ( walletA.create_transaction ( walletB.public_key, 1 ) );
+		if ( walletB.calculate_balance () > 0 )
+			chain.add_transaction ( walletB.create_transaction ( walletA.public_key, 1 ) );
 
 		if ( x == 1 ) {
-			chain.add_transaction ( test );
-			test.set_index ( chain.current_block.index + chain.current_block.transactions.size () );
+			Transaction transaction = walletA.create_transaction ( walletB.public_key, 2 );
+			chain.add_transaction ( transaction );
+
+			// Spending the same outputs twice is rejected
+			try {
+				chain.add_transaction ( transaction );
+			} catch ( const std::runtime_error &error ) {
+				std::cout << "Rejected double spend: " << error.what () << std::endl;
+			}
 		}
 
-		chain.mine_block ( y );
+		chain.mine_block ( walletA.create_coinbase ( walletA.public_key, 69 ) );
+		if ( x == 1 )
+			test = chain.get_block ( chain.height () - 1 ).transactions.back ().hash;
 	}
 
-	search::binary_search ( chain.blocks, chain.blocks.begin (), chain.blocks.end (), test.tx_index );
-}
\ No newline at end of file
+	walletA.sync ( chain );
+	walletB.sync ( chain );
+	std::cout << "Wallet A: " << walletA.calculate_balance () << " (" << chain.get_balance ( walletA.public_key ) << " on chain)" << std::endl;
+	std::cout << "Wallet B: " << walletB.calculate_balance () << " (" << chain.get_balance ( walletB.public_key ) << " on chain)" << std::endl;
+
+	search::binary_search ( chain.blocks, chain.get_transaction ( test ).tx_index () );
+}
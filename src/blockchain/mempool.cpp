@@ -0,0 +1,366 @@
+#include "mempool.h"
+
+/**
+ * The mempool constructor
+ *
+ * @param lookup - Finds an unspent output's value by its outpoint, returning whether it's unspent
+ */
+Mempool::Mempool ( Lookup lookup ): Mempool ( DEFAULT_MAX_BYTES, std::move ( lookup ) ) {}
+
+/**
+ * The mempool constructor
+ * (The lookup is called with the pool locked, so the chain must apply a
+ * block to its UTXO set before removing the block's transactions from the pool)
+ *
+ * @param max_bytes - The pool's memory budget
+ * @param lookup - Finds an unspent output's value by its outpoint, returning whether it's unspent
+ */
+Mempool::Mempool ( size_t max_bytes, Lookup lookup ) {
+	this -> lookup = std::move ( lookup );
+	this -> max_bytes = max_bytes;
+	this -> bytes = 0;
+	this -> sequence = 0;
+	this -> revision = 0;
+}
+
+bool Mempool::Key::operator< ( const Key &other ) const {
+	if ( this -> priority != other.priority )
+		return this -> priority > other.priority;
+
+	if ( this -> sequence != other.sequence )
+		return this -> sequence < other.sequence;
+
+	return this -> hash < other.hash;
+}
+
+/**
+ * Submits a transaction
+ * (The transaction is verified before the pool is locked, so submitters only
+ * contend for the index updates and the UTXO lookups. Its inputs are checked
+ * again when it's picked for a block)
+ *
+ * @param transaction - The transaction, which is moved into the pool if it's accepted
+ * @returns Whether or not the transaction is in the pool (false if it was evicted straight away)
+ */
+bool Mempool::add ( Transaction &&transaction ) {
+	return this -> add ( std::move ( transaction ), false );
+}
+
+/**
+ * Submits a transaction
+ *
+ * @param transaction - The transaction, which is moved into the pool if it's accepted
+ * @param is_verified - Whether or not the transaction was already fully verified by the caller
+ * @returns Whether or not the transaction is in the pool (false if it was evicted straight away)
+ */
+bool Mempool::add ( Transaction &&transaction, bool is_verified ) {
+	if ( !is_verified && !( transaction.verify ( false ) ) )
+		throw std::runtime_error ( "Attempted adding an invalid transaction to the mempool!" );
+
+	size_t size = measure ( transaction );
+	Hash256 hash = transaction.hash;
+
+	std::lock_guard<std::mutex> lock ( this -> mutex );
+	this -> insert ( std::move ( transaction ), size );
+	this -> evict ();
+	return this -> entries.count ( hash ) != 0;
+}
+
+/**
+ * Submits a batch of transactions
+ * (The transactions are verified and measured in parallel, then inserted in
+ * order under a single lock, so a transaction spending an output which an
+ * earlier one in the batch already spends is rejected. Rejected transactions
+ * are left untouched)
+ *
+ * @param transactions - The transactions, each one is moved into the pool if it's accepted
+ * @param threads - The number of threads used to verify them (0 uses every available core)
+ * @returns The outcome of each submission
+ */
+std::vector<SubmitResult> Mempool::add_many ( std::vector<Transaction> &transactions, unsigned int threads ) {
+	std::vector<SubmitResult> results ( transactions.size (), SubmitResult { false, "" } );
+	std::vector<size_t> sizes ( transactions.size () );
+
+	parallel::for_each ( transactions.size (), threads, [&] ( size_t x ) {
+		try {
+			if ( !( transactions[x].verify ( false ) ) )
+				throw std::runtime_error ( "Attempted adding an invalid transaction to the mempool!" );
+
+			sizes[x] = measure ( transactions[x] );
+			results[x].accepted = true;
+		} catch ( const std::runtime_error &error ) {
+			results[x].error = error.what ();
+		}
+	} );
+
+	std::vector<Hash256> hashes ( transactions.size () );
+	std::lock_guard<std::mutex> lock ( this -> mutex );
+	for ( size_t x = 0; x < transactions.size (); x++ ) {
+		if ( !( results[x].accepted ) )
+			continue;
+
+		hashes[x] = transactions[x].hash;
+		try {
+			this -> insert ( std::move ( transactions[x] ), sizes[x] );
+		} catch ( const std::runtime_error &error ) {
+			results[x] = SubmitResult { false, error.what () };
+		}
+	}
+
+	// Reports the submissions which were evicted straight away
+	this -> evict ();
+	for ( size_t x = 0; x < transactions.size (); x++ )
+		if ( results[x].accepted && this -> entries.count ( hashes[x] ) == 0 )
+			results[x] = SubmitResult { false, "Attempted adding a transaction with too low a priority for the mempool!" };
+
+	return results;
+}
+
+bool Mempool::contains ( const Hash256 &hash ) {
+	std::lock_guard<std::mutex> lock ( this -> mutex );
+	return this -> entries.count ( hash ) != 0;
+}
+
+/**
+ * Checks whether an output is spent by a pooled transaction
+ *
+ * @param outpoint - The output's outpoint
+ * @returns Whether or not a pooled transaction spends it
+ */
+bool Mempool::spends ( const Hash256 &outpoint ) {
+	std::lock_guard<std::mutex> lock ( this -> mutex );
+	return this -> spenders.count ( outpoint ) != 0;
+}
+
+/**
+ * Removes the highest priority transactions, to be mined
+ * (A transaction which doesn't fit is skipped, so smaller ones behind it can still fill the space)
+ *
+ * @param max_bytes - The most pool memory the taken transactions may account for
+ * @returns The transactions, highest priority first
+ */
+std::vector<Transaction> Mempool::take ( size_t max_bytes ) {
+	std::lock_guard<std::mutex> lock ( this -> mutex );
+
+	std::vector<Transaction> transactions;
+	size_t taken = 0;
+	for ( auto key = this -> order.begin (); key != this -> order.end (); ) {
+		auto entry = this -> entries.find ( key -> hash );
+		key++;
+
+		if ( taken + entry -> second.size > max_bytes )
+			continue;
+
+		taken += entry -> second.size;
+		transactions.push_back ( this -> erase ( entry ) );
+	}
+
+	return transactions;
+}
+
+/**
+ * Copies the highest priority transactions, leaving them in the pool
+ * (Used for block templates, which may be rebuilt many times before one is
+ * mined; the pooled transactions are removed once a block spending their
+ * inputs is connected)
+ *
+ * @param max_bytes - The most pool memory the selected transactions may account for
+ * @returns The transactions, highest priority first
+ */
+std::vector<Transaction> Mempool::select ( size_t max_bytes ) {
+	std::lock_guard<std::mutex> lock ( this -> mutex );
+
+	std::vector<Transaction> transactions;
+	size_t selected = 0;
+	for ( auto &key : this -> order ) {
+		const Entry &entry = this -> entries.at ( key.hash );
+		if ( selected + entry.size > max_bytes )
+			continue;
+
+		selected += entry.size;
+		transactions.push_back ( entry.transaction );
+	}
+
+	return transactions;
+}
+
+/**
+ * Lists the pooled transactions without copying them
+ *
+ * @returns The transactions' hashes, highest priority first
+ */
+std::vector<Hash256> Mempool::hashes () {
+	std::lock_guard<std::mutex> lock ( this -> mutex );
+
+	std::vector<Hash256> hashes;
+	hashes.reserve ( this -> order.size () );
+	for ( auto &key : this -> order )
+		hashes.push_back ( key.hash );
+
+	return hashes;
+}
+
+/**
+ * Copies some of the pooled transactions, leaving them in the pool
+ *
+ * @param hashes - The transactions' hashes
+ * @returns The transactions, in the order of their hashes
+ */
+std::vector<Transaction> Mempool::get ( const std::vector<Hash256> &hashes ) {
+	std::lock_guard<std::mutex> lock ( this -> mutex );
+
+	std::vector<Transaction> transactions;
+	transactions.reserve ( hashes.size () );
+	for ( auto &hash : hashes ) {
+		auto entry = this -> entries.find ( hash );
+		if ( entry == this -> entries.end () )
+			throw std::runtime_error ( "Attempted getting a transaction which isn't in the mempool!" );
+
+		transactions.push_back ( entry -> second.transaction );
+	}
+
+	return transactions;
+}
+
+/**
+ * Removes the transactions mined by a block, and the ones which conflict with them
+ * (Both are found through the outpoints they spend: mining sets a transaction's
+ * tx_index, so its mined hash isn't the one it was submitted with)
+ *
+ * @param block - A view of the stored block
+ * @returns The removed transactions, in the order the block spends their inputs
+ */
+std::vector<Transaction> Mempool::remove_block ( BlockView block ) {
+	std::lock_guard<std::mutex> lock ( this -> mutex );
+
+	std::vector<Transaction> removed;
+	if ( this -> entries.empty () )
+		return removed;
+
+	for ( TransactionIterator entry = block.begin (); entry != block.end (); ++entry ) {
+		if ( entry.position () == 0 )
+			continue;
+
+		TransactionView transaction = *entry;
+		for ( size_t x = 0; x < transaction.input_count (); x++ ) {
+			auto spender = this -> spenders.find ( transaction.input ( x ).hash () );
+			if ( spender != this -> spenders.end () )
+				removed.push_back ( this -> erase ( this -> entries.find ( spender -> second ) ) );
+		}
+	}
+
+	return removed;
+}
+
+void Mempool::clear () {
+	std::lock_guard<std::mutex> lock ( this -> mutex );
+	this -> entries.clear ();
+	this -> spenders.clear ();
+	this -> order.clear ();
+	this -> bytes = 0;
+	this -> revision++;
+}
+
+size_t Mempool::size () {
+	std::lock_guard<std::mutex> lock ( this -> mutex );
+	return this -> entries.size ();
+}
+
+/**
+ * Gets the memory the pool accounts for
+ *
+ * @returns The pooled transactions' encoded sizes plus ENTRY_OVERHEAD each
+ */
+size_t Mempool::memory_usage () {
+	std::lock_guard<std::mutex> lock ( this -> mutex );
+	return this -> bytes;
+}
+
+/**
+ * Gets a counter which changes whenever the pooled transactions do
+ *
+ * @returns The pool's revision
+ */
+uint64_t Mempool::get_revision () {
+	std::lock_guard<std::mutex> lock ( this -> mutex );
+	return this -> revision;
+}
+
+/**
+ * Measures a transaction's footprint
+ *
+ * @param transaction - The transaction
+ * @returns The pool memory the transaction accounts for
+ */
+size_t Mempool::measure ( Transaction &transaction ) {
+	serialize::Writer counter;
+	transaction.encode ( counter );
+
+	return counter.size () + ENTRY_OVERHEAD;
+}
+
+/**
+ * Indexes a verified transaction, the caller must hold the lock
+ * (Duplicates, double spends and spends of missing outputs are rejected,
+ * leaving the transaction untouched. The priority is the value of the spent
+ * outputs, as found in the UTXO set, per encoded byte)
+ *
+ * @param transaction - The transaction
+ * @param size - The pool memory the transaction accounts for
+ */
+void Mempool::insert ( Transaction &&transaction, size_t size ) {
+	Hash256 hash = transaction.hash;
+	if ( this -> entries.count ( hash ) != 0 )
+		throw std::runtime_error ( "Attempted adding a transaction which is already in the mempool!" );
+
+	for ( auto &input : transaction.inputs )
+		if ( this -> spenders.count ( input.hash ) != 0 )
+			throw std::runtime_error ( "Attempted adding a transaction which spends an output already spent in the mempool!" );
+
+	long value = 0;
+	for ( auto &input : transaction.inputs ) {
+		int64_t spent;
+		if ( !( this -> lookup ( input.hash, spent ) ) )
+			throw std::runtime_error ( "Attempted adding a transaction which spends a missing output!" );
+
+		value += spent;
+	}
+
+	double priority = (double) value / (double) ( size - ENTRY_OVERHEAD );
+
+	for ( auto &input : transaction.inputs )
+		this -> spenders[input.hash] = hash;
+
+	uint64_t sequence = this -> sequence++;
+	this -> order.insert ( Key { priority, sequence, hash } );
+	this -> entries.emplace ( hash, Entry { std::move ( transaction ), priority, sequence, size } );
+	this -> bytes += size;
+	this -> revision++;
+}
+
+/**
+ * Evicts the lowest priority transactions until the pool fits its budget, the caller must hold the lock
+ */
+void Mempool::evict () {
+	while ( this -> bytes > this -> max_bytes && !( this -> order.empty () ) )
+		this -> erase ( this -> entries.find ( std::prev ( this -> order.end () ) -> hash ) );
+}
+
+/**
+ * Removes an entry from every index, the caller must hold the lock
+ *
+ * @param entry - The entry
+ * @returns The entry's transaction
+ */
+Transaction Mempool::erase ( std::unordered_map<Hash256, Entry>::iterator entry ) {
+	for ( auto &input : entry -> second.transaction.inputs )
+		this -> spenders.erase ( input.hash );
+
+	this -> order.erase ( Key { entry -> second.priority, entry -> second.sequence, entry -> first } );
+	this -> bytes -= entry -> second.size;
+	this -> revision++;
+
+	Transaction transaction = std::move ( entry -> second.transaction );
+	this -> entries.erase ( entry );
+	return transaction;
+}
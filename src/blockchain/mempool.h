@@ -0,0 +1,95 @@
+#pragma once
+#ifndef MEMPOOL_H
+#define MEMPOOL_H
+
+#include <set>
+#include <mutex>
+#include <functional>
+#include <iterator>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <unordered_map>
+#include "views.h"
+#include "transaction.h"
+#include "algorithms/hash256.h"
+#include "algorithms/serialize.h"
+#include "algorithms/parallel.h"
+
+/**
+ * The outcome of submitting one transaction of a batch
+ */
+struct SubmitResult {
+	bool accepted;
+	std::string error;
+};
+
+/**
+ * The transactions waiting to be mined
+ * (Safe to submit to from any number of threads. Transactions are indexed by
+ * hash and by the outpoints they spend, so a conflicting transaction is
+ * rejected on submission, and are ordered by priority: the value they move
+ * per encoded byte, earliest first on ties. Spent outputs are looked up in
+ * the chain's UTXO set, which the submitter can't vouch for. Once the pool
+ * outgrows its memory budget the lowest priority transactions are evicted)
+ */
+class Mempool {
+	public:
+		static const size_t DEFAULT_MAX_BYTES = 64 << 20;
+		static const size_t ENTRY_OVERHEAD = 256;
+
+		typedef std::function<bool ( const Hash256 &outpoint, int64_t &value )> Lookup;
+
+		Mempool ( Lookup lookup );
+		Mempool ( size_t max_bytes, Lookup lookup );
+
+		bool add ( Transaction &&transaction );
+		bool add ( Transaction &&transaction, bool is_verified );
+		std::vector<SubmitResult> add_many ( std::vector<Transaction> &transactions, unsigned int threads );
+		bool contains ( const Hash256 &hash );
+		bool spends ( const Hash256 &outpoint );
+		std::vector<Transaction> take ( size_t max_bytes );
+		std::vector<Transaction> select ( size_t max_bytes );
+		std::vector<Hash256> hashes ();
+		std::vector<Transaction> get ( const std::vector<Hash256> &hashes );
+		std::vector<Transaction> remove_block ( BlockView block );
+		void clear ();
+
+		size_t size ();
+		size_t memory_usage ();
+		uint64_t get_revision ();
+
+	private:
+		struct Entry {
+			Transaction transaction;
+			double priority;
+			uint64_t sequence;
+			size_t size;
+		};
+
+		// Orders entries from the highest to the lowest priority
+		struct Key {
+			double priority;
+			uint64_t sequence;
+			Hash256 hash;
+
+			bool operator< ( const Key &other ) const;
+		};
+
+		std::mutex mutex;
+		Lookup lookup;
+		size_t max_bytes;
+		size_t bytes;
+		uint64_t sequence;
+		uint64_t revision;
+		std::unordered_map<Hash256, Entry> entries;
+		std::unordered_map<Hash256, Hash256> spenders;
+		std::set<Key> order;
+
+		static size_t measure ( Transaction &transaction );
+		void insert ( Transaction &&transaction, size_t size );
+		void evict ();
+		Transaction erase ( std::unordered_map<Hash256, Entry>::iterator entry );
+};
+
+#endif
@@ -0,0 +1,220 @@
+#include "miner.h"
+
+/**
+ * The miner constructor (mines on every available core)
+ *
+ * @param chain - The chain which mined blocks are added to
+ * @param coinbase - The coinbase of every mined block
+ */
+Miner::Miner ( Blockchain &chain, Transaction coinbase ): Miner ( chain, std::move ( coinbase ), std::thread::hardware_concurrency () ) {}
+
+/**
+ * The miner constructor
+ *
+ * @param chain - The chain which mined blocks are added to
+ * @param coinbase - The coinbase of every mined block
+ * @param threads - The number of worker threads
+ */
+Miner::Miner ( Blockchain &chain, Transaction coinbase, unsigned int threads ): chain ( chain ), coinbase ( std::move ( coinbase ) ) {
+	this -> threads = std::max ( threads, 1u );
+	this -> generation = 0;
+	this -> found = false;
+	this -> stopping = false;
+	this -> hashes = 0;
+	this -> solution = 0;
+	this -> mempool_revision = 0;
+}
+
+Miner::~Miner () {
+	this -> stop ();
+}
+
+/**
+ * Builds the first template and starts the workers
+ */
+void Miner::start () {
+	if ( !( this -> workers.empty () ) )
+		throw std::runtime_error ( "Attempted starting a miner which is already running!" );
+
+	this -> stopping = false;
+	this -> refresh ();
+
+	for ( unsigned int worker = 0; worker < this -> threads; worker++ )
+		this -> workers.emplace_back ( &Miner::run, this, worker );
+}
+
+/**
+ * Stops the workers, abandoning the current template
+ */
+void Miner::stop () {
+	{
+		std::lock_guard<std::mutex> lock ( this -> mutex );
+		this -> stopping = true;
+	}
+
+	this -> changed.notify_all ();
+	this -> solved.notify_all ();
+
+	for ( auto &worker : this -> workers )
+		worker.join ();
+
+	this -> workers.clear ();
+}
+
+/**
+ * Replaces the template with one built on the current tip and mempool
+ * (Must be called from the thread which owns the chain)
+ */
+void Miner::refresh () {
+	this -> mempool_revision = this -> chain.mempool.get_revision ();
+	this -> refreshed = std::chrono::steady_clock::now ();
+
+	uint64_t chain_revision = this -> chain.get_revision ();
+	Block block = this -> chain.create_template ( this -> coinbase );
+	crypto::sha256_midstate midstate = block.header_midstate ();
+
+	{
+		std::lock_guard<std::mutex> lock ( this -> mutex );
+		this -> work = std::make_shared<const Template> ( Template { std::move ( block ), midstate, this -> generation + 1, chain_revision } );
+		this -> generation++;
+		this -> found = false;
+	}
+
+	this -> changed.notify_all ();
+}
+
+/**
+ * Hands a solved block to the chain, and refreshes a stale template
+ * (Must be called from the thread which owns the chain, e.g. after every
+ * batch of submitted transactions or accepted blocks)
+ *
+ * @returns Whether or not a block was mined
+ */
+bool Miner::update () {
+	if ( this -> submit () ) {
+		this -> refresh ();
+		return true;
+	}
+
+	std::chrono::steady_clock::duration age = std::chrono::steady_clock::now () - this -> refreshed;
+	if ( this -> work -> chain_revision != this -> chain.get_revision () )
+		this -> refresh ();
+	else if ( this -> chain.mempool.get_revision () != this -> mempool_revision && std::chrono::duration_cast<std::chrono::milliseconds> ( age ).count () >= REFRESH_INTERVAL )
+		this -> refresh ();
+
+	return false;
+}
+
+/**
+ * Waits for the workers to solve the current template, then calls update ()
+ *
+ * @param timeout - The longest time to wait
+ * @returns Whether or not a block was mined
+ */
+bool Miner::wait ( std::chrono::milliseconds timeout ) {
+	{
+		std::unique_lock<std::mutex> lock ( this -> mutex );
+		this -> solved.wait_for ( lock, timeout, [this] () { return this -> found || this -> stopping; } );
+	}
+
+	return this -> update ();
+}
+
+/**
+ * Gets the number of templates built so far
+ *
+ * @returns The template count
+ */
+uint64_t Miner::get_templates () {
+	return this -> generation.load ();
+}
+
+/**
+ * Gets the number of headers hashed so far
+ *
+ * @returns The hash count
+ */
+uint64_t Miner::get_hashes () {
+	return this -> hashes.load ();
+}
+
+/**
+ * A worker's main loop
+ * (Worker n hashes every n-th batch of nonces, and moves on to the next
+ * template as soon as the one it's working on goes stale)
+ *
+ * @param worker - The worker's position
+ */
+void Miner::run ( unsigned int worker ) {
+	uint64_t done = 0;
+	while ( true ) {
+		std::shared_ptr<const Template> current;
+		{
+			std::unique_lock<std::mutex> lock ( this -> mutex );
+			this -> changed.wait ( lock, [this, done] () { return this -> stopping || this -> work -> generation != done; } );
+			if ( this -> stopping )
+				return;
+
+			current = this -> work;
+			done = current -> generation;
+		}
+
+		long long stride = (long long) this -> threads * Block::MINING_BATCH;
+		for ( long long candidate = (long long) worker * Block::MINING_BATCH; !( this -> is_stale ( *current ) ); candidate += stride ) {
+			long long nonce;
+			bool valid = current -> block.search_batch ( current -> midstate, candidate, 1, nonce );
+			this -> hashes.fetch_add ( Block::MINING_BATCH, std::memory_order_relaxed );
+			if ( !valid )
+				continue;
+
+			// Only reports a solution for the template which is still current
+			std::lock_guard<std::mutex> lock ( this -> mutex );
+			if ( current -> generation == this -> generation && !( this -> found ) ) {
+				this -> solution = nonce;
+				this -> found = true;
+				this -> solved.notify_all ();
+			}
+
+			break;
+		}
+	}
+}
+
+/**
+ * Checks whether a template is no longer worth hashing
+ * (It's been replaced or solved, or a block was connected since it was built)
+ *
+ * @param work - The template
+ * @returns Whether or not the template is stale
+ */
+bool Miner::is_stale ( const Template &work ) {
+	return this -> stopping.load ( std::memory_order_relaxed ) || this -> found.load ( std::memory_order_relaxed ) || work.generation != this -> generation.load ( std::memory_order_relaxed ) || work.chain_revision != this -> chain.get_revision ();
+}
+
+/**
+ * Adds the solved template to the chain
+ * (If the chain refuses the block, the template is rebuilt so the workers
+ * carry on instead of waiting on a solution which will never be used)
+ *
+ * @returns Whether or not a solution for the current tip was added to the chain
+ */
+bool Miner::submit () {
+	Block block;
+	{
+		std::lock_guard<std::mutex> lock ( this -> mutex );
+		if ( !( this -> found ) || this -> work -> chain_revision != this -> chain.get_revision () )
+			return false;
+
+		block = this -> work -> block;
+		block.nonce = this -> solution;
+	}
+
+	block.calculate_hash ();
+	try {
+		if ( this -> chain.accept_block ( std::move ( block ) ) )
+			return true;
+	} catch ( const std::runtime_error & ) {}
+
+	this -> refresh ();
+	return false;
+}
@@ -0,0 +1,75 @@
+#pragma once
+#ifndef MINER_H
+#define MINER_H
+
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <cstdint>
+#include "block.h"
+#include "blockchain.h"
+#include "transaction.h"
+#include "algorithms/crypto.h"
+
+/**
+ * Mines blocks in the background from a block template
+ * (The workers only ever hash the template's header, so the thread which owns
+ * the chain keeps using it while they run: transactions are still submitted
+ * and blocks from elsewhere still accepted. update () swaps in a new template
+ * when the tip moves, or when the mempool has changed and the template is
+ * older than REFRESH_INTERVAL milliseconds. The workers keep running across
+ * templates and drop stale work within one batch of hashes)
+ */
+class Miner {
+	public:
+		static const int REFRESH_INTERVAL = 100;
+
+		Miner ( Blockchain &chain, Transaction coinbase );
+		Miner ( Blockchain &chain, Transaction coinbase, unsigned int threads );
+		~Miner ();
+
+		void start ();
+		void stop ();
+		void refresh ();
+		bool update ();
+		bool wait ( std::chrono::milliseconds timeout );
+
+		uint64_t get_templates ();
+		uint64_t get_hashes ();
+
+	private:
+		struct Template {
+			Block block;
+			crypto::sha256_midstate midstate;
+			uint64_t generation;
+			uint64_t chain_revision;
+		};
+
+		Blockchain &chain;
+		Transaction coinbase;
+		unsigned int threads;
+		std::vector<std::thread> workers;
+
+		std::mutex mutex;
+		std::condition_variable changed;
+		std::condition_variable solved;
+		std::shared_ptr<const Template> work;
+		std::atomic<uint64_t> generation;
+		std::atomic<bool> found;
+		std::atomic<bool> stopping;
+		std::atomic<uint64_t> hashes;
+		long long solution;
+
+		uint64_t mempool_revision;
+		std::chrono::steady_clock::time_point refreshed;
+
+		void run ( unsigned int worker );
+		bool is_stale ( const Template &work );
+		bool submit ();
+};
+
+#endif
@@ -0,0 +1,705 @@
+#include "network_simulator.h"
+
+/**
+ * The simulator constructor
+ * (Mines a genesis block on the first node and starts every other node's
+ * chain from it. Node i is linked to the next degree / 2 nodes after it, so
+ * every node has about degree peers)
+ *
+ * @param nodes - The number of nodes (at least one)
+ * @param degree - The number of peers each node is linked to
+ * @param link - Every link's latency in milliseconds and bandwidth in bytes per millisecond
+ * @param relay - Whether blocks are relayed in full or as compact announcements
+ * @param difficulty - The mining difficulty
+ * @param reward - The mining reward
+ * @param coinbase - The genesis block's coinbase
+ */
+NetworkSimulator::NetworkSimulator ( size_t nodes, size_t degree, LinkConfig link, Relay relay, int difficulty, long reward, Transaction coinbase ) {
+	if ( nodes == 0 )
+		throw std::runtime_error ( "Attempted simulating a network without nodes!" );
+
+	this -> relay = relay;
+	this -> clock = 0;
+	this -> sequence = 0;
+	this -> transaction_bytes = 0;
+
+	// Creates the chains
+	this -> nodes.resize ( nodes );
+	this -> nodes[0].chain = std::make_unique<Blockchain> ( difficulty, reward, std::move ( coinbase ) );
+	Block genesis = this -> nodes[0].chain -> get_block ( 0 );
+	for ( size_t node = 0; node < nodes; node++ ) {
+		if ( node != 0 )
+			this -> nodes[node].chain = std::make_unique<Blockchain> ( genesis, difficulty, reward, this -> nodes[0].chain -> threads );
+
+		this -> nodes[node].blocks.emplace ( genesis.hash, genesis );
+		this -> nodes[node].busy_until = 0;
+	}
+
+	// Links the nodes
+	size_t span = std::max<size_t> ( degree / 2, 1 );
+	for ( size_t node = 0; node < nodes; node++ )
+		for ( size_t offset = 1; offset <= span && offset < nodes; offset++ ) {
+			size_t peer = ( node + offset ) % nodes;
+			bool linked = false;
+			for ( auto existing : this -> nodes[node].links )
+				linked = linked || this -> links[existing].to == peer;
+
+			if ( !linked )
+				this -> connect ( node, peer, link );
+		}
+}
+
+/**
+ * Links two nodes in both directions
+ *
+ * @param first - The first node
+ * @param second - The second node
+ * @param link - The link's latency in milliseconds and bandwidth in bytes per millisecond
+ */
+void NetworkSimulator::connect ( size_t first, size_t second, LinkConfig link ) {
+	if ( first >= this -> nodes.size () || second >= this -> nodes.size () || first == second )
+		throw std::runtime_error ( "Attempted linking invalid nodes!" );
+
+	if ( link.bandwidth <= 0 || link.latency < 0 )
+		throw std::runtime_error ( "Attempted creating a link with an invalid latency or bandwidth!" );
+
+	this -> nodes[first].links.push_back ( this -> links.size () );
+	this -> links.push_back ( Link { first, second, link, this -> clock } );
+	this -> nodes[second].links.push_back ( this -> links.size () );
+	this -> links.push_back ( Link { second, first, link, this -> clock } );
+}
+
+size_t NetworkSimulator::size () {
+	return this -> nodes.size ();
+}
+
+/**
+ * Gets a node's chain
+ * (Transactions added to it directly aren't relayed, as if they had been
+ * kept private until the node mined them)
+ *
+ * @param node - The node
+ * @returns The chain
+ */
+Blockchain &NetworkSimulator::chain ( size_t node ) {
+	return *( this -> nodes.at ( node ).chain );
+}
+
+/**
+ * Gets the simulated time
+ *
+ * @returns The milliseconds since the simulation started
+ */
+double NetworkSimulator::now () {
+	return this -> clock;
+}
+
+/**
+ * Gets the bytes spent relaying transactions, which compact announcements rely on
+ *
+ * @returns The bytes sent over every link
+ */
+uint64_t NetworkSimulator::get_transaction_bytes () {
+	return this -> transaction_bytes;
+}
+
+/**
+ * Submits a transaction to a node, which floods it to the network
+ *
+ * @param node - The node
+ * @param transaction - The transaction
+ * @returns Whether or not the node's mempool accepted the transaction
+ */
+bool NetworkSimulator::submit ( size_t node, Transaction transaction ) {
+	Node &source = this -> nodes.at ( node );
+	source.transactions.insert ( transaction.hash );
+	source.ids[transaction.hash] = neutral_hash ( transaction );
+
+	std::string encoding = transaction.to_bytes ();
+	if ( !( source.chain -> mempool.add ( std::move ( transaction ) ) ) )
+		return false;
+
+	std::string bytes = serialize::to_bytes ( [&] ( serialize::Writer &writer ) {
+		writer.u8 ( TX );
+		writer.bytes ( encoding );
+	} );
+
+	for ( auto link : source.links )
+		this -> send ( link, bytes, Hash256 {} );
+
+	this -> flush ( std::max ( this -> clock, source.busy_until ) );
+	return true;
+}
+
+/**
+ * Mines a block on a node and runs the network until the block has propagated
+ *
+ * @param node - The node
+ * @param coinbase - The block's coinbase
+ * @returns The block's propagation time and relay cost
+ */
+NetworkSimulator::BlockReport NetworkSimulator::mine ( size_t node, Transaction coinbase ) {
+	Node &miner = this -> nodes.at ( node );
+	miner.chain -> mine_block ( std::move ( coinbase ) );
+
+	Block block = miner.chain -> get_block ( miner.chain -> height () - 1 );
+	Hash256 hash = block.hash;
+	double time = std::max ( this -> clock, miner.busy_until );
+
+	BlockStats &stats = this -> stats[hash];
+	stats = BlockStats { block.transactions.size (), block.to_bytes ().size (), node, time, {}, 0, 0, 0, 0 };
+	stats.arrivals[node] = 0;
+
+	miner.blocks.emplace ( hash, std::move ( block ) );
+	this -> announce ( node, node, miner.blocks.at ( hash ) );
+	this -> flush ( time );
+	this -> run ();
+
+	// Reports the block
+	BlockReport report { hash, stats.transactions, stats.size, stats.arrivals.size (), 0, 0, stats.bytes, stats.messages, stats.requests, stats.requested };
+	for ( auto &arrival : stats.arrivals ) {
+		report.propagation = std::max ( report.propagation, arrival.second );
+		report.mean_propagation += arrival.second;
+	}
+
+	if ( report.reached > 1 )
+		report.mean_propagation /= report.reached - 1;
+
+	return report;
+}
+
+/**
+ * Delivers messages, in the order they arrive, until none are left in flight
+ */
+void NetworkSimulator::run () {
+	while ( !( this -> events.empty () ) ) {
+		auto next = this -> events.begin ();
+		double time = next -> first.first;
+		Event event = std::move ( next -> second );
+		this -> events.erase ( next );
+
+		this -> deliver ( time, event );
+	}
+}
+
+/**
+ * Has a node handle a message, once it's done with the ones before it
+ * (The node is busy for as long as the handling really takes, and only then
+ * sends what the message made it send. A malformed or invalid message is dropped)
+ *
+ * @param time - The time the message arrived
+ * @param event - The message
+ */
+void NetworkSimulator::deliver ( double time, const Event &event ) {
+	const Link &link = this -> links[event.link];
+	Node &target = this -> nodes[link.to];
+	double start = std::max ( time, target.busy_until );
+
+	std::chrono::steady_clock::time_point began = std::chrono::steady_clock::now ();
+	try {
+		this -> handle ( link.to, link.from, event.bytes );
+	} catch ( const std::runtime_error &error ) {
+		this -> outbox.clear ();
+	}
+
+	double finished = start + std::chrono::duration<double, std::milli> ( std::chrono::steady_clock::now () - began ).count ();
+	target.busy_until = finished;
+	this -> clock = std::max ( this -> clock, finished );
+
+	// Records when the blocks the message completed were connected
+	for ( auto &hash : this -> connected ) {
+		BlockStats &stats = this -> stats[hash];
+		stats.arrivals[link.to] = finished - stats.mined;
+	}
+
+	this -> connected.clear ();
+	this -> flush ( finished );
+}
+
+/**
+ * Sends the queued messages
+ * (A message leaves once every earlier message on its link has, and arrives
+ * a latency after its last byte has left)
+ *
+ * @param time - The time the messages are sent
+ */
+void NetworkSimulator::flush ( double time ) {
+	for ( auto &outgoing : this -> outbox ) {
+		Link &link = this -> links[outgoing.link];
+		double departure = std::max ( time, link.busy_until );
+		link.busy_until = departure + outgoing.bytes.size () / link.config.bandwidth;
+
+		if ( outgoing.block.is_zero () ) {
+			this -> transaction_bytes += outgoing.bytes.size ();
+		} else {
+			BlockStats &stats = this -> stats[outgoing.block];
+			stats.bytes += outgoing.bytes.size ();
+			stats.messages++;
+		}
+
+		this -> events.emplace ( std::make_pair ( link.busy_until + link.config.latency, this -> sequence++ ), Event { outgoing.link, std::move ( outgoing.bytes ) } );
+	}
+
+	this -> outbox.clear ();
+}
+
+/**
+ * Queues a message, sent once the node is done with the one it's handling
+ *
+ * @param link - The link to send the message over
+ * @param bytes - The message
+ * @param block - The block the message relays (zero for a transaction)
+ */
+void NetworkSimulator::send ( size_t link, std::string bytes, const Hash256 &block ) {
+	this -> outbox.push_back ( Outgoing { link, std::move ( bytes ), block } );
+}
+
+/**
+ * Handles a message
+ *
+ * @param node - The node which recieved the message
+ * @param from - The peer which sent it
+ * @param bytes - The message
+ */
+void NetworkSimulator::handle ( size_t node, size_t from, const std::string &bytes ) {
+	serialize::Reader reader ( reinterpret_cast<const unsigned char*> ( bytes.data () ), bytes.size () );
+	switch ( reader.u8 () ) {
+		case TX:
+			this -> receive_transaction ( node, from, reader );
+			return;
+
+		case BLOCK:
+			this -> connect_block ( node, from, Block::decode ( reader.raw ( reader.remaining () ) ) );
+			return;
+
+		case COMPACT_BLOCK:
+			this -> receive_compact_block ( node, from, reader );
+			return;
+
+		case GET_BLOCK_TXN:
+			this -> receive_block_request ( node, from, reader );
+			return;
+
+		case BLOCK_TXN:
+			this -> receive_block_transactions ( node, from, reader );
+			return;
+
+		default:
+			throw std::runtime_error ( "Recieved an unknown message!" );
+	}
+}
+
+/**
+ * Adds a flooded transaction to a node's mempool, and passes it on
+ *
+ * @param node - The node
+ * @param from - The peer which sent the transaction
+ * @param reader - The message, past its type
+ */
+void NetworkSimulator::receive_transaction ( size_t node, size_t from, serialize::Reader &reader ) {
+	serialize::Span encoding = reader.bytes ();
+	Transaction transaction = Transaction::decode ( encoding );
+
+	Node &target = this -> nodes[node];
+	if ( !( target.transactions.insert ( transaction.hash ).second ) )
+		return;
+
+	Hash256 hash = transaction.hash;
+	Hash256 id = neutral_hash ( transaction );
+	if ( !( target.chain -> mempool.add ( std::move ( transaction ) ) ) )
+		return;
+
+	target.ids[hash] = id;
+
+	std::string bytes = serialize::to_bytes ( [&] ( serialize::Writer &writer ) {
+		writer.u8 ( TX );
+		writer.bytes ( encoding.data, encoding.size );
+	} );
+
+	for ( auto link : target.links )
+		if ( this -> links[link].to != from )
+			this -> send ( link, bytes, Hash256 {} );
+}
+
+/**
+ * Rebuilds an announced block from a node's mempool
+ * (Pooled transactions are matched by short ID and given their place in the
+ * block, which is completed straight away if none are missing; otherwise the
+ * missing ones are requested from the announcing peer)
+ *
+ * @param node - The node
+ * @param from - The peer which announced the block
+ * @param reader - The message, past its type
+ */
+void NetworkSimulator::receive_compact_block ( size_t node, size_t from, serialize::Reader &reader ) {
+	Node &target = this -> nodes[node];
+
+	PartialBlock partial;
+	partial.hash = reader.hash ();
+	if ( target.blocks.count ( partial.hash ) != 0 || target.partial.count ( partial.hash ) != 0 )
+		return;
+
+	partial.prev_block = reader.hash ();
+	partial.merkel_tree = reader.hash ();
+	partial.time = reader.i64 ();
+	partial.index = reader.i64 ();
+	partial.nonce = reader.i64 ();
+	partial.difficulty = reader.u32 ();
+	partial.missing = 0;
+	partial.refetched = false;
+	serialize::Span coinbase = reader.bytes ();
+
+	uint32_t count = reader.u32 ();
+	if ( reader.remaining () != (size_t) count * SHORT_ID_SIZE )
+		throw std::runtime_error ( "Recieved a malformed compact block!" );
+
+	// Indexes the mempool by short ID (a short ID shared by several transactions matches none of them)
+	std::vector<Hash256> pooled = target.chain -> mempool.hashes ();
+	this -> identify ( node, pooled );
+
+	std::unordered_map<uint64_t, size_t> ids;
+	for ( size_t x = 0; x < pooled.size (); x++ ) {
+		auto inserted = ids.emplace ( short_id ( partial.hash, target.ids.at ( pooled[x] ) ), x );
+		if ( !( inserted.second ) )
+			inserted.first -> second = pooled.size ();
+	}
+
+	// Matches the short IDs
+	partial.transactions.resize ( count + 1 );
+	partial.transactions[0] = coinbase.to_string ();
+
+	bool missing = false;
+	std::vector<Hash256> matched;
+	std::vector<uint32_t> positions;
+	for ( uint32_t position = 1; position <= count; position++ ) {
+		serialize::Span raw = reader.raw ( SHORT_ID_SIZE );
+		uint64_t id = 0;
+		for ( size_t x = 0; x < SHORT_ID_SIZE; x++ )
+			id |= (uint64_t) raw.data[x] << ( 8 * x );
+
+		auto match = ids.find ( id );
+		if ( match == ids.end () || match -> second == pooled.size () ) {
+			missing = true;
+			continue;
+		}
+
+		matched.push_back ( pooled[match -> second] );
+		positions.push_back ( position );
+	}
+
+	// Fills in the matched transactions, the only ones copied out of the pool
+	std::vector<Transaction> transactions = target.chain -> mempool.get ( matched );
+	for ( size_t x = 0; x < transactions.size (); x++ ) {
+		transactions[x].set_index ( partial.index + positions[x] );
+		partial.transactions[positions[x]] = transactions[x].to_bytes ();
+	}
+
+	if ( !( missing ) ) {
+		this -> complete ( node, from, std::move ( partial ) );
+		return;
+	}
+
+	this -> request ( node, from, std::move ( partial ) );
+}
+
+/**
+ * Sends a peer the transactions it's missing from a block
+ *
+ * @param node - The node which has the block
+ * @param from - The peer which requested the transactions
+ * @param reader - The message, past its type
+ */
+void NetworkSimulator::receive_block_request ( size_t node, size_t from, serialize::Reader &reader ) {
+	Hash256 hash = reader.hash ();
+	auto block = this -> nodes[node].blocks.find ( hash );
+	if ( block == this -> nodes[node].blocks.end () )
+		return;
+
+	std::vector<uint32_t> positions ( reader.u32 () );
+	for ( auto &position : positions ) {
+		position = reader.u32 ();
+		if ( position == 0 || position >= block -> second.transactions.size () )
+			throw std::runtime_error ( "Recieved a request for a transaction outside the block!" );
+	}
+
+	this -> send ( this -> link ( node, from ), serialize::to_bytes ( [&] ( serialize::Writer &writer ) {
+		writer.u8 ( BLOCK_TXN );
+		writer.hash ( hash );
+		writer.u32 ( positions.size () );
+		for ( auto position : positions ) {
+			size_t length = writer.begin_length ();
+			block -> second.transactions[position].encode ( writer );
+			writer.end_length ( length );
+		}
+	} ), hash );
+
+	this -> stats[hash].requested += positions.size ();
+}
+
+/**
+ * Completes a compact block with the transactions a node requested
+ * (They arrive in the order they were requested)
+ *
+ * @param node - The node
+ * @param from - The peer which sent the transactions
+ * @param reader - The message, past its type
+ */
+void NetworkSimulator::receive_block_transactions ( size_t node, size_t from, serialize::Reader &reader ) {
+	Node &target = this -> nodes[node];
+	auto partial = target.partial.find ( reader.hash () );
+	if ( partial == target.partial.end () )
+		return;
+
+	if ( reader.u32 () != partial -> second.missing )
+		throw std::runtime_error ( "Recieved the wrong number of block transactions!" );
+
+	for ( auto &transaction : partial -> second.transactions )
+		if ( transaction.empty () )
+			transaction = reader.bytes ().to_string ();
+
+	PartialBlock completed = std::move ( partial -> second );
+	target.partial.erase ( partial );
+	this -> complete ( node, from, std::move ( completed ) );
+}
+
+/**
+ * Requests the transactions a node is missing from a compact block
+ *
+ * @param node - The node
+ * @param from - The peer which announced the block
+ * @param partial - The block, with the missing transactions left empty
+ */
+void NetworkSimulator::request ( size_t node, size_t from, PartialBlock partial ) {
+	std::vector<uint32_t> missing;
+	for ( uint32_t position = 1; position < partial.transactions.size (); position++ )
+		if ( partial.transactions[position].empty () )
+			missing.push_back ( position );
+
+	partial.missing = missing.size ();
+	Hash256 hash = partial.hash;
+	this -> nodes[node].partial.emplace ( hash, std::move ( partial ) );
+
+	this -> send ( this -> link ( node, from ), serialize::to_bytes ( [&] ( serialize::Writer &writer ) {
+		writer.u8 ( GET_BLOCK_TXN );
+		writer.hash ( hash );
+		writer.u32 ( missing.size () );
+		for ( auto position : missing )
+			writer.u32 ( position );
+	} ), hash );
+
+	this -> stats[hash].requests++;
+}
+
+/**
+ * Connects a completed compact block
+ * (A block rebuilt from the mempool which fails to connect, e.g. because a
+ * short ID matched the wrong transaction and broke the merkel tree, has every
+ * transaction requested from the announcing peer instead. Only a block made
+ * of the peer's own transactions is dropped as invalid)
+ *
+ * @param node - The node
+ * @param from - The peer which announced the block
+ * @param partial - The block, with every transaction filled in
+ */
+void NetworkSimulator::complete ( size_t node, size_t from, PartialBlock partial ) {
+	std::string bytes = this -> assemble ( partial );
+	try {
+		this -> connect_block ( node, from, Block::decode ( serialize::Span { reinterpret_cast<const unsigned char*> ( bytes.data () ), bytes.size () } ) );
+		return;
+	} catch ( const std::runtime_error & ) {
+		if ( partial.refetched || partial.transactions.size () == 1 )
+			throw;
+	}
+
+	// Refetches every transaction but the coinbase, which came with the announcement
+	partial.refetched = true;
+	for ( size_t position = 1; position < partial.transactions.size (); position++ )
+		partial.transactions[position].clear ();
+
+	this -> request ( node, from, std::move ( partial ) );
+}
+
+/**
+ * Adds a block to a node's chain and announces it to the node's other peers
+ *
+ * @param node - The node
+ * @param from - The peer which sent the block
+ * @param block - The block
+ * @returns Whether or not the block was new to the node
+ */
+bool NetworkSimulator::connect_block ( size_t node, size_t from, Block block ) {
+	Node &target = this -> nodes[node];
+	if ( target.blocks.count ( block.hash ) != 0 )
+		return false;
+
+	Hash256 hash = block.hash;
+	target.chain -> accept_block ( block );
+	target.blocks.emplace ( hash, std::move ( block ) );
+	this -> connected.push_back ( hash );
+
+	this -> announce ( node, from, target.blocks.at ( hash ) );
+	return true;
+}
+
+/**
+ * Pushes a block to every peer of a node but the one it came from
+ *
+ * @param node - The node
+ * @param from - The peer which sent the block (the node itself if it mined it)
+ * @param block - The block
+ */
+void NetworkSimulator::announce ( size_t node, size_t from, Block &block ) {
+	std::string bytes;
+	if ( this -> relay == FULL ) {
+		bytes = serialize::to_bytes ( [&] ( serialize::Writer &writer ) {
+			writer.u8 ( BLOCK );
+			block.encode ( writer );
+		} );
+	} else {
+		std::vector<uint64_t> ids;
+		for ( size_t position = 1; position < block.transactions.size (); position++ )
+			ids.push_back ( short_id ( block.hash, neutral_hash ( block.transactions[position] ) ) );
+
+		bytes = serialize::to_bytes ( [&] ( serialize::Writer &writer ) {
+			writer.u8 ( COMPACT_BLOCK );
+			writer.hash ( block.hash );
+			writer.hash ( block.prev_block );
+			writer.hash ( block.merkel_tree );
+			writer.i64 ( block.time.count () );
+			writer.i64 ( block.index );
+			writer.i64 ( block.nonce );
+			writer.u32 ( (uint32_t) block.difficulty );
+
+			size_t length = writer.begin_length ();
+			block.transactions.front ().encode ( writer );
+			writer.end_length ( length );
+
+			writer.u32 ( ids.size () );
+			for ( auto id : ids ) {
+				unsigned char raw[SHORT_ID_SIZE];
+				for ( size_t x = 0; x < SHORT_ID_SIZE; x++ )
+					raw[x] = (unsigned char)( id >> ( 8 * x ) );
+
+				writer.raw ( raw, SHORT_ID_SIZE );
+			}
+		} );
+	}
+
+	for ( auto link : this -> nodes[node].links )
+		if ( this -> links[link].to != from )
+			this -> send ( link, bytes, block.hash );
+}
+
+/**
+ * Writes a completed compact block out as a block encoding
+ * (The block carries no keys, every node shares the key table)
+ *
+ * @param partial - The block's header and encoded transactions
+ * @returns The block's encoding
+ */
+std::string NetworkSimulator::assemble ( PartialBlock &partial ) {
+	return serialize::to_bytes ( [&] ( serialize::Writer &writer ) {
+		writer.u8 ( serialize::VERSION );
+		writer.hash ( partial.hash );
+		writer.hash ( partial.prev_block );
+		writer.hash ( partial.merkel_tree );
+		writer.i64 ( partial.time );
+		writer.i64 ( partial.index );
+		writer.i64 ( partial.nonce );
+		writer.u32 ( partial.difficulty );
+
+		writer.u32 ( partial.transactions.size () );
+		for ( auto &transaction : partial.transactions )
+			writer.bytes ( transaction );
+
+		writer.u32 ( 0 );
+	} );
+}
+
+/**
+ * Finds the link from one node to another
+ *
+ * @param from - The sending node
+ * @param to - The recieving node
+ * @returns The link's position
+ */
+size_t NetworkSimulator::link ( size_t from, size_t to ) {
+	for ( auto link : this -> nodes[from].links )
+		if ( this -> links[link].to == to )
+			return link;
+
+	throw std::runtime_error ( "Attempted sending to a node which isn't a peer!" );
+}
+
+/**
+ * Caches the tx_index neutral hash of every pooled transaction of a node
+ * (Flooded transactions are cached as they arrive, so only the ones added
+ * to the chain directly or returned to the pool by a reorganization are
+ * copied here. Entries for transactions which left the pool are dropped)
+ *
+ * @param node - The node
+ * @param pooled - The hashes of the node's pooled transactions
+ */
+void NetworkSimulator::identify ( size_t node, const std::vector<Hash256> &pooled ) {
+	Node &target = this -> nodes[node];
+
+	std::unordered_map<Hash256, Hash256> ids;
+	std::vector<Hash256> unknown;
+	for ( auto &hash : pooled ) {
+		auto known = target.ids.find ( hash );
+		if ( known == target.ids.end () )
+			unknown.push_back ( hash );
+		else
+			ids.emplace ( hash, known -> second );
+	}
+
+	for ( auto &transaction : target.chain -> mempool.get ( unknown ) )
+		ids.emplace ( transaction.hash, neutral_hash ( transaction ) );
+
+	target.ids.swap ( ids );
+}
+
+/**
+ * Calculates the hash a transaction has with its tx_index set to zero
+ * (Mining sets the index and so changes the hash, this one stays the same.
+ * Unmined transactions already have it; a mined one is rehashed twice, and
+ * left as it was)
+ *
+ * @param transaction - The transaction
+ * @returns The hash
+ */
+Hash256 NetworkSimulator::neutral_hash ( Transaction &transaction ) {
+	if ( transaction.tx_index == 0 )
+		return transaction.hash;
+
+	long index = transaction.tx_index;
+	transaction.set_index ( 0 );
+	Hash256 hash = transaction.hash;
+	transaction.set_index ( index );
+
+	return hash;
+}
+
+/**
+ * Calculates a transaction's short ID within a block
+ * (Derived from the transaction's tx_index neutral hash, which commits to
+ * its whole encoding, salted with the block's hash so colliding IDs don't
+ * collide in every block. Two transactions spending the same outputs only
+ * share an ID by chance)
+ *
+ * @param block - The block's hash
+ * @param transaction - The transaction's tx_index neutral hash
+ * @returns The ID, in its low SHORT_ID_SIZE bytes
+ */
+uint64_t NetworkSimulator::short_id ( const Hash256 &block, const Hash256 &transaction ) {
+	unsigned char salted[2 * SHA256_DIGEST_LENGTH];
+	std::memcpy ( salted, block.bytes, SHA256_DIGEST_LENGTH );
+	std::memcpy ( salted + SHA256_DIGEST_LENGTH, transaction.bytes, SHA256_DIGEST_LENGTH );
+
+	Hash256 digest = crypto::sha256 ( salted, sizeof ( salted ) );
+	uint64_t id = 0;
+	for ( size_t x = 0; x < SHORT_ID_SIZE; x++ )
+		id |= (uint64_t) digest.bytes[x] << ( 8 * x );
+
+	return id;
+}
@@ -0,0 +1,161 @@
+#pragma once
+#ifndef NETWORK_SIMULATOR_H
+#define NETWORK_SIMULATOR_H
+
+#include <map>
+#include <string>
+#include <vector>
+#include <memory>
+#include <chrono>
+#include <thread>
+#include <cstdint>
+#include <limits>
+#include <algorithm>
+#include <stdexcept>
+#include <unordered_map>
+#include <unordered_set>
+#include "block.h"
+#include "blockchain.h"
+#include "transaction.h"
+#include "algorithms/crypto.h"
+#include "algorithms/hash256.h"
+#include "algorithms/serialize.h"
+
+/**
+ * Runs several chains as peers of an in-process network, to measure how
+ * blocks propagate
+ * (Time is simulated: every message is delivered after its link's latency
+ * plus the time its bytes take at the link's bandwidth, queued behind the
+ * link's earlier messages, and each node handles one message at a time for
+ * as long as the handling really took. Transactions are flooded to every
+ * peer. Blocks are pushed to every peer either in full or as compact
+ * announcements: the header, the coinbase and a short ID for every other
+ * transaction, which peers match against their own mempool, fetching only
+ * the transactions they're missing. The key table is shared by every node,
+ * so signing keys are never relayed)
+ */
+class NetworkSimulator {
+	public:
+		enum Relay { FULL, COMPACT };
+		enum Message : uint8_t { TX, BLOCK, COMPACT_BLOCK, GET_BLOCK_TXN, BLOCK_TXN };
+
+		static const size_t SHORT_ID_SIZE = 6;
+
+		struct LinkConfig {
+			double latency;
+			double bandwidth;
+		};
+
+		struct BlockReport {
+			Hash256 hash;
+			size_t transactions;
+			size_t size;
+			size_t reached;
+			double propagation;
+			double mean_propagation;
+			uint64_t bytes;
+			uint64_t messages;
+			uint64_t requests;
+			uint64_t requested;
+		};
+
+		NetworkSimulator ( size_t nodes, size_t degree, LinkConfig link, Relay relay, int difficulty, long reward, Transaction coinbase );
+
+		void connect ( size_t first, size_t second, LinkConfig link );
+		size_t size ();
+		Blockchain &chain ( size_t node );
+		double now ();
+		uint64_t get_transaction_bytes ();
+
+		bool submit ( size_t node, Transaction transaction );
+		BlockReport mine ( size_t node, Transaction coinbase );
+		void run ();
+
+	private:
+		struct Link {
+			size_t from;
+			size_t to;
+			LinkConfig config;
+			double busy_until;
+		};
+
+		struct PartialBlock {
+			Hash256 hash;
+			Hash256 prev_block;
+			Hash256 merkel_tree;
+			int64_t time;
+			int64_t index;
+			int64_t nonce;
+			uint32_t difficulty;
+			std::vector<std::string> transactions;
+			size_t missing;
+			bool refetched;
+		};
+
+		struct Node {
+			std::unique_ptr<Blockchain> chain;
+			std::vector<size_t> links;
+			std::unordered_set<Hash256> transactions;
+			std::unordered_map<Hash256, Hash256> ids;
+			std::unordered_map<Hash256, Block> blocks;
+			std::unordered_map<Hash256, PartialBlock> partial;
+			double busy_until;
+		};
+
+		struct Event {
+			size_t link;
+			std::string bytes;
+		};
+
+		struct Outgoing {
+			size_t link;
+			std::string bytes;
+			Hash256 block;
+		};
+
+		struct BlockStats {
+			size_t transactions;
+			size_t size;
+			size_t origin;
+			double mined;
+			std::unordered_map<size_t, double> arrivals;
+			uint64_t bytes;
+			uint64_t messages;
+			uint64_t requests;
+			uint64_t requested;
+		};
+
+		Relay relay;
+		std::vector<Node> nodes;
+		std::vector<Link> links;
+		std::map<std::pair<double, uint64_t>, Event> events;
+		std::vector<Outgoing> outbox;
+		std::vector<Hash256> connected;
+		std::unordered_map<Hash256, BlockStats> stats;
+		double clock;
+		uint64_t sequence;
+		uint64_t transaction_bytes;
+
+		void deliver ( double time, const Event &event );
+		void flush ( double time );
+		void send ( size_t link, std::string bytes, const Hash256 &block );
+		void handle ( size_t node, size_t from, const std::string &bytes );
+
+		void receive_transaction ( size_t node, size_t from, serialize::Reader &reader );
+		void receive_compact_block ( size_t node, size_t from, serialize::Reader &reader );
+		void receive_block_request ( size_t node, size_t from, serialize::Reader &reader );
+		void receive_block_transactions ( size_t node, size_t from, serialize::Reader &reader );
+		void request ( size_t node, size_t from, PartialBlock partial );
+		void complete ( size_t node, size_t from, PartialBlock partial );
+		bool connect_block ( size_t node, size_t from, Block block );
+		void announce ( size_t node, size_t from, Block &block );
+		std::string assemble ( PartialBlock &partial );
+
+		size_t link ( size_t from, size_t to );
+		void identify ( size_t node, const std::vector<Hash256> &pooled );
+
+		static Hash256 neutral_hash ( Transaction &transaction );
+		static uint64_t short_id ( const Hash256 &block, const Hash256 &transaction );
+};
+
+#endif
@@ -0,0 +1,143 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include "wallet.h"
+#include "block.h"
+#include "blockchain.h"
+#include "transaction.h"
+#include "validation_pipeline.h"
+
+static int failures = 0;
+
+/**
+ * Reports a failed check
+ *
+ * @param condition - The checked condition
+ * @param message - What was checked
+ */
+static void check ( bool condition, const std::string &message ) {
+	if ( condition )
+		return;
+
+	std::cout << "FAILED: " << message << std::endl;
+	failures++;
+}
+
+/**
+ * Submits valid and invalid blocks and transactions to a pipeline, checking
+ * where each is rejected and that the outcomes come back in order, then
+ * stops pipelines while a submitter is blocked on a full queue
+ */
+int main () {
+	Wallet miner ( crypto::SignatureScheme::ed25519 () );
+	Wallet user ( crypto::SignatureScheme::ed25519 () );
+
+	// Mines a chain to replay, whose last block carries a transaction
+	Blockchain source ( 1, 69, miner.create_coinbase ( miner.public_key, 69 ), 2 );
+	for ( int block = 0; block < 8; block++ )
+		source.mine_block ( miner.create_coinbase ( miner.public_key, 69 ) );
+
+	miner.sync ( source );
+	source.add_transaction ( miner.create_transaction ( user.public_key, 1 ) );
+	source.mine_block ( miner.create_coinbase ( miner.public_key, 69 ) );
+	Block tip = source.get_block ( source.height () - 1 );
+
+	Transaction valid = miner.create_transaction ( user.public_key, 1 );
+	Transaction forged = miner.create_transaction ( user.public_key, 1 );
+	forged.outputs[0].signature[0] ^= 1;
+	forged.calculate_hash ();
+
+	// A header which no longer meets the difficulty (one leading zero nibble)
+	Block unmined = tip;
+	do {
+		unmined.nonce++;
+		unmined.calculate_hash ();
+	} while ( ( unmined.hash.bytes[0] & 0xF0 ) == 0 );
+
+	// The same block, also shipping a key which no output uses (the tip's only signing key is the miner's)
+	std::string stranger = "-----BEGIN PUBLIC KEY-----\nnot a key\n-----END PUBLIC KEY-----\n";
+	std::string shipped = unmined.to_bytes ();
+	std::string keys = serialize::to_bytes ( [&] ( serialize::Writer &writer ) { writer.u32 ( 1 ); writer.bytes ( miner.public_key ); } );
+	check ( shipped.size () > keys.size () && shipped.compare ( shipped.size () - keys.size (), keys.size (), keys ) == 0, "the tip ships only the miner's key" );
+	shipped.replace ( shipped.size () - keys.size (), keys.size (), serialize::to_bytes ( [&] ( serialize::Writer &writer ) { writer.u32 ( 2 ); writer.bytes ( miner.public_key ); writer.bytes ( stranger ); } ) );
+
+	// A valid header over a transaction which changed after mining
+	Block tampered = tip;
+	tampered.transactions[1].outputs[0].value++;
+
+	Blockchain chain ( source.get_block ( 0 ), 1, 69, 2 );
+	{
+		ValidationPipeline pipeline ( chain, 2 );
+		std::vector<bool> expected;
+		for ( size_t height = 1; height < source.height (); height++ ) {
+			pipeline.submit_block ( source.get_block ( height ).to_bytes () );
+			expected.push_back ( true );
+		}
+
+		pipeline.submit_block ( "not a block" );
+		pipeline.submit_block ( shipped );
+		pipeline.submit_block ( tampered.to_bytes () );
+		pipeline.submit_transaction ( valid.to_bytes () );
+		pipeline.submit_transaction ( forged.to_bytes () );
+		expected.insert ( expected.end (), { false, false, false, true, false } );
+
+		std::vector<SubmitResult> results = pipeline.drain ();
+		check ( results.size () == expected.size (), "every submission has an outcome" );
+		for ( size_t x = 0; x < results.size () && x < expected.size (); x++ )
+			check ( results[x].accepted == expected[x], "submission " + std::to_string ( x ) + " is " + ( expected[x] ? "accepted" : "rejected" ) + " (" + results[x].error + ")" );
+
+		std::vector<ValidationPipeline::StageStats> stats = pipeline.stats ();
+		check ( stats[ValidationPipeline::DECODE].rejected == 1, "garbage bytes are rejected at decode" );
+		check ( stats[ValidationPipeline::STRUCTURE].rejected == 1, "a block without proof of work is rejected at structure" );
+		check ( stats[ValidationPipeline::HASHES].rejected == 1, "a tampered block is rejected at hashes" );
+		check ( stats[ValidationPipeline::SIGNATURES].rejected == 1, "a forged signature is rejected at signatures" );
+		check ( stats[ValidationPipeline::COMMIT].rejected == 0, "nothing is rejected at commit" );
+
+		check ( chain.height () == source.height () && chain.get_block ( chain.height () - 1 ).hash == tip.hash, "the valid blocks are committed" );
+		check ( chain.mempool.size () == 1 && chain.mempool.contains ( valid.hash ), "the valid transaction is pooled" );
+		check ( pipeline.drain ().empty (), "drained outcomes aren't reported again" );
+		check ( !( KeyTable::global ().has_pem ( KeyTable::global ().intern ( KeyTable::key_id ( stranger ) ) ) ), "a rejected block's keys aren't kept" );
+	}
+
+	// Stops pipelines with one slot per queue at different points of a blocked submission
+	std::string bytes = valid.to_bytes ();
+	bool balanced = true;
+	bool refused = true;
+	for ( int trial = 0; trial < 20; trial++ ) {
+		std::array<ValidationPipeline::StageConfig, ValidationPipeline::STAGES> config;
+		config.fill ( ValidationPipeline::StageConfig { 1, 1 } );
+		ValidationPipeline pipeline ( chain, config );
+
+		std::atomic<size_t> submitted { 0 };
+		std::thread submitter ( [&] () {
+			try {
+				while ( true ) {
+					pipeline.submit_transaction ( bytes );
+					submitted++;
+				}
+			} catch ( const std::runtime_error & ) {}
+		} );
+
+		std::this_thread::sleep_for ( std::chrono::microseconds ( 200 * trial ) );
+		pipeline.stop ();
+		submitter.join ();
+
+		// drain () must return, with an outcome for every submission which went through
+		balanced = balanced && pipeline.drain ().size () == submitted.load ();
+
+		try {
+			pipeline.submit_transaction ( bytes );
+			refused = false;
+		} catch ( const std::runtime_error & ) {}
+	}
+
+	check ( balanced, "stopping during a blocked submission leaves an outcome for every accepted submission" );
+	check ( refused, "a stopped pipeline refuses submissions" );
+
+	std::cout << ( failures == 0 ? "All pipeline checks passed" : std::to_string ( failures ) + " pipeline checks failed" ) << std::endl;
+	return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,85 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <cstdlib>
+#include <algorithm>
+#include "wallet.h"
+#include "blockchain.h"
+#include "transaction.h"
+#include "network_simulator.h"
+
+/**
+ * Relays one block of a given number of transactions across a fresh network
+ * (The miner first mines a block per transaction, so its wallet has an
+ * output for each, then floods all but the hidden transactions to the
+ * network and mines them into one block)
+ *
+ * @param relay - Whether the block is relayed in full or as a compact announcement
+ * @param count - The number of transactions in the block, besides its coinbase
+ * @param hidden - The number of those the miner kept to itself
+ * @returns The block's report
+ */
+static NetworkSimulator::BlockReport relay_block ( NetworkSimulator::Relay relay, size_t count, size_t hidden ) {
+	Wallet miner ( crypto::SignatureScheme::ed25519 () );
+	Wallet recipient ( crypto::SignatureScheme::ed25519 () );
+
+	// 12 nodes of 4 peers, over 50ms links at 10Mbit/s
+	NetworkSimulator network ( 12, 4, NetworkSimulator::LinkConfig { 50, 1250 }, relay, 1, 69, miner.create_coinbase ( miner.public_key, 69 ) );
+	for ( size_t block = 0; block < count; block++ )
+		network.mine ( 0, miner.create_coinbase ( miner.public_key, 69 ) );
+
+	miner.sync ( network.chain ( 0 ) );
+	for ( size_t x = 0; x < count; x++ ) {
+		Transaction transaction = miner.create_transaction ( recipient.public_key, 1 );
+		if ( x < count - hidden )
+			network.submit ( 0, std::move ( transaction ) );
+		else
+			network.chain ( 0 ).add_transaction ( std::move ( transaction ) );
+	}
+
+	network.run ();
+	return network.mine ( 0, miner.create_coinbase ( miner.public_key, 69 ) );
+}
+
+/**
+ * Prints one benchmark row
+ *
+ * @param name - The relay mode
+ * @param report - The relayed block's report
+ */
+static void print ( const std::string &name, const NetworkSimulator::BlockReport &report ) {
+	std::cout << std::left << std::setw ( 20 ) << name << std::right << std::fixed << std::setprecision ( 1 ) << std::setw ( 8 ) << report.reached << std::setw ( 13 ) << report.propagation << std::setw ( 11 ) << report.mean_propagation << std::setw ( 12 ) << report.bytes << std::setw ( 10 ) << report.messages << std::setw ( 10 ) << report.requests << std::setw ( 11 ) << report.requested << std::endl;
+}
+
+/**
+ * Compares full block relay against compact block relay on the same workload
+ * (Run with the number of transactions per block, 200 by default, and the
+ * number of them the miner keeps to itself in the last run, 20 by default.
+ * Propagation is the simulated time until the block reached the last node,
+ * and the mean over every other node)
+ */
+int main ( int argc, char **argv ) {
+	size_t count = argc > 1 ? std::max ( std::atoi ( argv[1] ), 1 ) : 200;
+	size_t hidden = argc > 2 ? std::min<size_t> ( std::max ( std::atoi ( argv[2] ), 0 ), count ) : std::min<size_t> ( 20, count );
+
+	std::cout << count << " transactions per block" << std::endl;
+	std::cout << std::left << std::setw ( 20 ) << "relay" << std::right << std::setw ( 8 ) << "nodes" << std::setw ( 13 ) << "last (ms)" << std::setw ( 11 ) << "mean (ms)" << std::setw ( 12 ) << "bytes" << std::setw ( 10 ) << "messages" << std::setw ( 10 ) << "requests" << std::setw ( 11 ) << "requested" << std::endl;
+
+	std::vector<NetworkSimulator::BlockReport> reports {
+		relay_block ( NetworkSimulator::FULL, count, 0 ),
+		relay_block ( NetworkSimulator::COMPACT, count, 0 ),
+		relay_block ( NetworkSimulator::COMPACT, count, hidden )
+	};
+
+	print ( "full", reports[0] );
+	print ( "compact", reports[1] );
+	print ( "compact, " + std::to_string ( hidden ) + " hidden", reports[2] );
+
+	// Every run must have reached the whole network
+	for ( auto &report : reports )
+		if ( report.reached != 12 )
+			return 1;
+
+	return 0;
+}
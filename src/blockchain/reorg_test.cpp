@@ -0,0 +1,272 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <random>
+#include <limits>
+#include <cstdint>
+#include <stdexcept>
+#include <unordered_set>
+#include "wallet.h"
+#include "block.h"
+#include "blockchain.h"
+#include "transaction.h"
+#include "key_table.h"
+
+static int failures = 0;
+
+/**
+ * Reports a failed check
+ *
+ * @param condition - The checked condition
+ * @param message - What was checked
+ */
+static void check ( bool condition, const std::string &message ) {
+	if ( condition )
+		return;
+
+	std::cout << "FAILED: " << message << std::endl;
+	failures++;
+}
+
+/**
+ * Spends one of a wallet's outputs on a chain, sending 1 to a recipient and the rest back
+ * (Outputs are picked only once across every chain, so the test decides where they conflict)
+ *
+ * @param chain - The chain whose UTXO set the output is picked from
+ * @param wallet - The wallet which owns the output
+ * @param recipient - The recipient's public key
+ * @param used - The outpoints which have already been picked
+ * @param above - If set, only coinbases mined above this height are picked
+ * @returns The signed transaction
+ */
+static Transaction spend ( Blockchain &chain, Wallet &wallet, const std::string &recipient, std::unordered_set<Hash256> &used, size_t above = 0 ) {
+	KeyTable::Handle key = KeyTable::global ().intern ( wallet.public_key );
+	for ( auto &ref : chain.get_history ( wallet.public_key, 0, SIZE_MAX ) ) {
+		TransactionOutput output = chain.blocks.view ( ref.height ).transaction ( ref.position ).output ( ref.output ).to_output ();
+		if ( ( above != 0 && ( ref.height <= above || ref.position != 0 ) ) || output.recipient != key || !( chain.utxos.contains ( output.outpoint () ) ) || !( used.insert ( output.outpoint () ).second ) )
+			continue;
+
+		std::vector<TransactionInput> inputs;
+		inputs.emplace_back ( std::move ( output ) );
+
+		Transaction transaction ( std::move ( inputs ), key, KeyTable::global ().intern ( recipient ), 1 );
+		wallet.sign_transaction ( &transaction );
+		transaction.calculate_hash ();
+
+		return transaction;
+	}
+
+	throw std::runtime_error ( "No spendable output left!" );
+}
+
+/**
+ * Checks that every pooled transaction spends available outputs, and no output twice
+ *
+ * @param chain - The chain
+ * @returns Whether or not the pool is consistent with the UTXO set
+ */
+static bool pool_is_valid ( Blockchain &chain ) {
+	std::unordered_set<Hash256> spent;
+	for ( auto &transaction : chain.mempool.select ( std::numeric_limits<size_t>::max () ) )
+		for ( auto &input : transaction.inputs )
+			if ( !( chain.utxos.contains ( input.hash ) ) || !( spent.insert ( input.hash ).second ) )
+				return false;
+
+	return true;
+}
+
+/**
+ * Checks whether a transaction's inputs are all spent by the pool
+ *
+ * @param chain - The chain
+ * @param transaction - The transaction
+ * @returns Whether or not the pool holds a spend of every input
+ */
+static bool is_pooled ( Blockchain &chain, const Transaction &transaction ) {
+	for ( auto &input : transaction.inputs )
+		if ( !( chain.mempool.spends ( input.hash ) ) )
+			return false;
+
+	return true;
+}
+
+/**
+ * Feeds a chain every block another chain has above a height
+ *
+ * @param chain - The chain receiving the blocks
+ * @param source - The chain the blocks are taken from
+ * @param fork - The last height both chains share
+ */
+static void relay ( Blockchain &chain, Blockchain &source, size_t fork ) {
+	for ( size_t height = fork + 1; height < source.height (); height++ )
+		chain.accept_block ( source.get_block ( height ) );
+}
+
+/**
+ * Reorganizes a node onto generated branches of growing depth, then onto an
+ * invalid branch
+ * (Run with a seed to generate different branches, e.g. reorg_test 7. Each
+ * round node X mines a branch of shared, conflicting, X-only and dependent
+ * transactions, while node Y mines a longer one from the same tip, which is
+ * then relayed to X. A wallet synced on both sides of a reorg must follow it,
+ * and no branch may fork deeper than Blockchain::MAX_REORG_DEPTH)
+ */
+int main ( int argc, char **argv ) {
+	std::mt19937 random ( argc > 1 ? std::stoul ( argv[1] ) : 1 );
+
+	Wallet miner ( crypto::SignatureScheme::ed25519 () );
+	Wallet user ( crypto::SignatureScheme::ed25519 () );
+	Wallet other ( crypto::SignatureScheme::ed25519 () );
+
+	Blockchain x ( 1, 69, miner.create_coinbase ( miner.public_key, 69 ), 1 );
+	Blockchain y ( x.get_block ( 0 ), 1, 69, 1 );
+	std::unordered_set<Hash256> used;
+
+	// Gives both nodes a stock of shared outputs
+	for ( int block = 0; block < 24; block++ ) {
+		Wallet &owner = block % 3 == 0 ? other : miner;
+		x.mine_block ( owner.create_coinbase ( owner.public_key, 69 ) );
+	}
+
+	relay ( y, x, 0 );
+
+	for ( size_t depth = 1; depth <= 10; depth++ ) {
+		size_t fork = x.height () - 1;
+		check ( y.height () == x.height () && y.get_block ( fork ).hash == x.get_block ( fork ).hash, "nodes share the tip before round " + std::to_string ( depth ) );
+
+		Transaction shared = spend ( x, miner, user.public_key, used );
+		Transaction conflicted = spend ( x, miner, user.public_key, used );
+		Transaction conflicting = conflicted;
+		conflicting.outputs.clear ();
+		conflicting.create_outputs ( KeyTable::global ().intern ( miner.public_key ), KeyTable::global ().intern ( other.public_key ), 1 );
+		miner.sign_transaction ( &conflicting );
+		conflicting.calculate_hash ();
+
+		// Mines X's branch, one transaction per block
+		std::vector<Transaction> x_only;
+		std::vector<Transaction> dependent;
+		x.add_transaction ( shared );
+		x.add_transaction ( conflicted );
+		for ( size_t block = 0; block < depth; block++ ) {
+			if ( block > 0 && random () % 2 == 0 ) {
+
+				// Spends a coinbase of X's branch, which must not survive the reorg
+				dependent.push_back ( spend ( x, miner, user.public_key, used, fork ) );
+				x.add_transaction ( dependent.back () );
+			} else {
+				x_only.push_back ( spend ( x, miner, user.public_key, used ) );
+				x.add_transaction ( x_only.back () );
+			}
+
+			x.mine_block ( miner.create_coinbase ( miner.public_key, 69 ) );
+		}
+
+		// Mines Y's longer branch
+		y.add_transaction ( shared );
+		y.add_transaction ( conflicting );
+		size_t length = depth + 1 + random () % 2;
+		for ( size_t block = 0; block < length; block++ ) {
+			if ( random () % 2 == 0 )
+				y.add_transaction ( spend ( y, other, user.public_key, used ) );
+
+			y.mine_block ( other.create_coinbase ( other.public_key, 69 ) );
+		}
+
+		relay ( x, y, fork );
+
+		std::string round = " after a reorg of depth " + std::to_string ( depth );
+		check ( x.height () == y.height () && x.get_block ( x.height () - 1 ).hash == y.get_block ( y.height () - 1 ).hash, "X follows Y's branch" + round );
+		check ( x.verify_chain (), "X's chain verifies" + round );
+		check ( pool_is_valid ( x ), "X's pool only spends available outputs" + round );
+		check ( !( is_pooled ( x, shared ) ) && !( is_pooled ( x, conflicted ) ), "X drops the transactions Y mined or conflicted with" + round );
+
+		for ( auto &transaction : x_only )
+			check ( is_pooled ( x, transaction ) && x.utxos.contains ( transaction.inputs[0].hash ), "X returns its own transactions to the pool" + round );
+
+		for ( auto &transaction : dependent )
+			check ( !( is_pooled ( x, transaction ) ), "X drops spends of outputs only its branch created" + round );
+
+		// Mines X's restored transactions into the shared chain
+		x.mine_block ( miner.create_coinbase ( miner.public_key, 69 ) );
+		check ( x.mempool.size () == 0, "X mines every restored transaction" + round );
+		relay ( y, x, y.height () - 1 );
+	}
+
+	// Pays a wallet twice on X's branch and once on Y's longer one, so its history shrinks
+	Wallet payee ( crypto::SignatureScheme::ed25519 () );
+	size_t fork = x.height () - 1;
+
+	x.add_transaction ( spend ( x, miner, payee.public_key, used ) );
+	x.add_transaction ( spend ( x, miner, payee.public_key, used ) );
+	x.mine_block ( miner.create_coinbase ( miner.public_key, 69 ) );
+	payee.sync ( x );
+	check ( payee.calculate_balance () == 2, "a wallet sees its outputs on X's branch" );
+
+	y.add_transaction ( spend ( y, other, payee.public_key, used ) );
+	y.mine_block ( other.create_coinbase ( other.public_key, 69 ) );
+	y.mine_block ( other.create_coinbase ( other.public_key, 69 ) );
+	relay ( x, y, fork );
+
+	payee.sync ( x );
+	check ( payee.calculate_balance () == 1 && x.get_balance ( payee.public_key ) == 1, "a wallet paid only on the winning branch sees its balance" );
+
+	// Forks the chain as deep as a reorganization may reach, then one block deeper
+	while ( x.height () < Blockchain::MAX_REORG_DEPTH + 2 )
+		x.mine_block ( miner.create_coinbase ( miner.public_key, 69 ) );
+
+	for ( size_t depth = Blockchain::MAX_REORG_DEPTH; depth <= Blockchain::MAX_REORG_DEPTH + 1; depth++ ) {
+		Block parent = x.get_block ( x.height () - 1 - depth );
+		Block stale ( parent.hash, parent.index + parent.transactions.size (), 1 );
+		stale.set_coinbase ( other.create_coinbase ( other.public_key, 69 ) );
+		stale.mine_block ( 1 );
+
+		bool rejected = false;
+		try {
+			x.accept_block ( stale );
+		} catch ( const std::runtime_error & ) {
+			rejected = true;
+		}
+
+		check ( rejected == ( depth > Blockchain::MAX_REORG_DEPTH ), "a fork " + std::to_string ( depth ) + " blocks deep is " + ( depth > Blockchain::MAX_REORG_DEPTH ? "rejected" : "kept" ) );
+	}
+
+	// Builds a branch whose second block spends an output which only exists on another chain
+	Blockchain z ( 1, 69, other.create_coinbase ( other.public_key, 69 ), 1 );
+	std::unordered_set<Hash256> foreign;
+	Transaction invalid = spend ( z, other, user.public_key, foreign );
+
+	x.mine_block ( miner.create_coinbase ( miner.public_key, 69 ) );
+	Transaction pending = spend ( x, miner, user.public_key, used );
+	x.add_transaction ( pending );
+
+	size_t tip = x.height () - 1;
+	Hash256 tip_hash = x.get_block ( tip ).hash;
+	Block parent = x.get_block ( tip - 1 );
+
+	Block first ( parent.hash, parent.index + parent.transactions.size (), 1 );
+	first.set_coinbase ( other.create_coinbase ( other.public_key, 69 ) );
+	first.add_transaction ( pending );
+	first.mine_block ( 1 );
+
+	Block second ( first.hash, first.index + first.transactions.size (), 1 );
+	second.set_coinbase ( other.create_coinbase ( other.public_key, 69 ) );
+	second.add_transaction ( invalid );
+	second.mine_block ( 1 );
+
+	check ( !( x.accept_block ( first ) ), "an equally long branch stays on the side" );
+
+	bool thrown = false;
+	try {
+		x.accept_block ( second );
+	} catch ( const std::runtime_error & ) {
+		thrown = true;
+	}
+
+	check ( thrown, "an invalid branch is rejected" );
+	check ( x.height () == tip + 1 && x.get_block ( tip ).hash == tip_hash, "the previous chain is restored after an invalid branch" );
+	check ( x.verify_chain (), "X's chain verifies after an invalid branch" );
+	check ( is_pooled ( x, pending ) && pool_is_valid ( x ), "the pool survives an invalid branch" );
+
+	std::cout << ( failures == 0 ? "All reorg checks passed" : std::to_string ( failures ) + " reorg checks failed" ) << std::endl;
+	return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,65 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <string>
+#include <cstdlib>
+#include <algorithm>
+#include <stdexcept>
+#include "algorithms/signature.h"
+
+/**
+ * Times a callable, averaged over several runs
+ *
+ * @param runs - The number of runs
+ * @param run - The callable
+ * @returns The mean time of one run in microseconds
+ */
+template <typename Run>
+static double measure ( int runs, Run run ) {
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now ();
+	for ( int x = 0; x < runs; x++ )
+		run ();
+
+	return std::chrono::duration<double, std::micro> ( std::chrono::steady_clock::now () - start ).count () / runs;
+}
+
+/**
+ * Benchmarks key generation, signing and verification for every signature scheme
+ * (Run with a number to scale the iteration counts, e.g. signature_bench 10)
+ */
+int main ( int argc, char **argv ) {
+	int scale = argc > 1 ? std::max ( std::atoi ( argv[1] ), 1 ) : 1;
+	std::string payload ( 128, 'x' );
+
+	struct Case {
+		std::shared_ptr<crypto::SignatureScheme> scheme;
+		int keygens;
+		int signs;
+	};
+
+	std::vector<Case> cases {
+		{ crypto::SignatureScheme::ed25519 (), 200, 2000 },
+		{ crypto::SignatureScheme::rsa ( 1024 ), 20, 1000 },
+		{ crypto::SignatureScheme::rsa ( 2048 ), 5, 200 },
+		{ crypto::SignatureScheme::rsa ( 4096 ), 1, 50 }
+	};
+
+	std::cout << std::left << std::setw ( 12 ) << "scheme" << std::right << std::setw ( 14 ) << "keygen (us)" << std::setw ( 12 ) << "sign (us)" << std::setw ( 14 ) << "verify (us)" << std::setw ( 16 ) << "signature (B)" << std::endl;
+	for ( auto &test : cases ) {
+		double keygen = measure ( test.keygens * scale, [&] () { EVP_PKEY_free ( test.scheme -> generate_keypair () ); } );
+
+		EVP_PKEY *keypair = test.scheme -> generate_keypair ();
+		std::string signature;
+		double sign = measure ( test.signs * scale, [&] () { signature = test.scheme -> sign ( keypair, payload ); } );
+
+		bool valid = true;
+		double verify = measure ( test.signs * scale, [&] () { valid = valid && test.scheme -> verify ( keypair, payload, signature ); } );
+		EVP_PKEY_free ( keypair );
+
+		if ( !valid )
+			throw std::runtime_error ( "Failed to verify a benchmark signature!" );
+
+		std::cout << std::left << std::setw ( 12 ) << test.scheme -> name () << std::right << std::fixed << std::setprecision ( 1 ) << std::setw ( 14 ) << keygen << std::setw ( 12 ) << sign << std::setw ( 14 ) << verify << std::setw ( 16 ) << signature.size () << std::endl;
+	}
+}
@@ -0,0 +1,105 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <random>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include "wallet.h"
+#include "block.h"
+#include "blockchain.h"
+#include "chain_snapshot.h"
+
+/**
+ * Checks that a snapshot's blocks still match its headers
+ *
+ * @param snapshot - The snapshot
+ * @param height - The block which should be checked
+ * @returns Whether or not the block's bytes hash to its header's hash
+ */
+static bool is_intact ( const ChainSnapshot &snapshot, size_t height ) {
+	Block block = snapshot.get_block ( height );
+	return block.verify_hash () && block.hash == snapshot.header ( height ).hash && ( height == 0 || block.prev_block == snapshot.header ( height - 1 ).hash );
+}
+
+/**
+ * Reads snapshots from 32 threads while one writer keeps reorganizing the chain
+ * (Run with the number of reorganizations, 200 by default. One reader holds
+ * the first snapshot for the whole run, which the writer must not wait for;
+ * the others take a new snapshot for every read)
+ */
+int main ( int argc, char **argv ) {
+	int rounds = argc > 1 ? std::max ( std::atoi ( argv[1] ), 1 ) : 200;
+	const unsigned int readers = 32;
+
+	Wallet walletA ( crypto::SignatureScheme::ed25519 () );
+	Wallet walletB ( crypto::SignatureScheme::ed25519 () );
+	Blockchain chain ( 1, 69, walletA.create_coinbase ( walletA.public_key, 69 ), 1 );
+	Blockchain rival ( chain.get_block ( 0 ), 1, 69, 1 );
+
+	std::atomic<bool> done { false };
+	std::atomic<uint64_t> reads { 0 };
+	std::atomic<uint64_t> failures { 0 };
+
+	// Holds the first snapshot until the writer is done
+	std::shared_ptr<const ChainSnapshot> held = chain.snapshot ();
+	std::thread holder ( [&] () {
+		while ( !( done.load () ) )
+			std::this_thread::sleep_for ( std::chrono::milliseconds ( 1 ) );
+
+		for ( size_t height = 0; height < held -> size (); height++ )
+			if ( !( is_intact ( *held, height ) ) )
+				failures++;
+	} );
+
+	std::vector<std::thread> threads;
+	for ( unsigned int reader = 1; reader < readers; reader++ )
+		threads.emplace_back ( [&, reader] () {
+			std::mt19937 random ( reader );
+			while ( !( done.load () ) ) {
+				std::shared_ptr<const ChainSnapshot> snapshot = chain.snapshot ();
+				size_t height = snapshot -> size () - 1 - random () % std::min<size_t> ( snapshot -> size (), 8 );
+
+				if ( !( is_intact ( *snapshot, height ) ) || snapshot -> get_balance ( walletA.public_key ) < 0 )
+					failures++;
+
+				reads++;
+			}
+		} );
+
+	// Forks the chain at its tip every round, and lets a longer branch replace the blocks mined on it
+	std::mt19937 random ( 1 );
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now ();
+	for ( int round = 0; round < rounds; round++ ) {
+		for ( size_t height = rival.height (); height < chain.height (); height++ )
+			rival.accept_block ( chain.get_block ( height ) );
+
+		size_t fork = chain.height ();
+		size_t depth = 1 + random () % 4;
+		for ( size_t block = 0; block < depth; block++ )
+			chain.mine_block ( walletA.create_coinbase ( walletA.public_key, 69 ) );
+
+		for ( size_t block = 0; block <= depth; block++ )
+			rival.mine_block ( walletB.create_coinbase ( walletB.public_key, 69 ) );
+
+		for ( size_t height = fork; height < rival.height (); height++ )
+			chain.accept_block ( rival.get_block ( height ) );
+
+		if ( chain.get_block ( chain.height () - 1 ).hash != rival.get_block ( rival.height () - 1 ).hash )
+			failures++;
+	}
+
+	double elapsed = std::chrono::duration<double> ( std::chrono::steady_clock::now () - start ).count ();
+	done = true;
+	holder.join ();
+	for ( auto &thread : threads )
+		thread.join ();
+
+	if ( !( chain.verify_chain () ) )
+		failures++;
+
+	std::cout << rounds << " reorganizations in " << elapsed << "s, " << reads.load () << " snapshot reads by " << readers << " readers, " << failures.load () << " failures" << std::endl;
+	return failures.load () == 0 && reads.load () > 0 ? 0 : 1;
+}
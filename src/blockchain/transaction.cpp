@@ -7,9 +7,9 @@
  * @param author - The transaction author
  * @param recipient - The transaction recipient
  * @param amount - The amount of coin the recipient should recieve
+ * @param allocator - Where the transaction's inputs and outputs are stored
  */
-Transaction::Transaction ( std::vector<TransactionInput> inputs, std::string author, std::string recipient, long amount ) {
-	this -> inputs = inputs;
+Transaction::Transaction ( std::vector<TransactionInput> inputs, KeyTable::Handle author, KeyTable::Handle recipient, long amount, const allocator_type &allocator ): inputs ( std::make_move_iterator ( inputs.begin () ), std::make_move_iterator ( inputs.end () ), allocator ), outputs ( allocator ) {
 	this -> tx_index = 0;
 	this -> create_outputs ( author, recipient, amount );
 	this -> set_timestamp ();
@@ -21,43 +21,69 @@ Transaction::Transaction ( std::vector<TransactionInput> inputs, std::string aut
  *
  * @param inputs - The UTXO transaction inputs
  * @param outputs - The UTXO transaction outputs
+ * @param allocator - Where the transaction's inputs and outputs are stored
  */
-Transaction::Transaction ( std::vector<TransactionInput> inputs, std::vector<TransactionOutput> outputs ) {
-	this -> inputs = inputs;
-	this -> outputs = outputs;
+Transaction::Transaction ( std::vector<TransactionInput> inputs, std::vector<TransactionOutput> outputs, const allocator_type &allocator ): inputs ( std::make_move_iterator ( inputs.begin () ), std::make_move_iterator ( inputs.end () ), allocator ), outputs ( std::make_move_iterator ( outputs.begin () ), std::make_move_iterator ( outputs.end () ), allocator ) {
 	this -> tx_index = 0;
 	this -> set_timestamp ();
 	this -> calculate_hash ();
 }
 
+/**
+ * The decoding constructor
+ *
+ * @param allocator - Where the transaction's inputs and outputs are stored
+ */
+Transaction::Transaction ( const allocator_type &allocator ): inputs ( allocator ), outputs ( allocator ) {
+	this -> tx_index = 0;
+}
+
+/**
+ * Copies a transaction into another allocator
+ * (Used by pmr containers, so that a whole block's transactions share its arena)
+ *
+ * @param other - The transaction which should be copied
+ * @param allocator - Where the copy's inputs and outputs are stored
+ */
+Transaction::Transaction ( const Transaction &other, const allocator_type &allocator ): hash ( other.hash ), tx_index ( other.tx_index ), time ( other.time ), inputs ( other.inputs, allocator ), outputs ( other.outputs, allocator ) {}
+
+/**
+ * Moves a transaction into another allocator
+ * (Only steals the inputs and outputs if both allocators use the same resource)
+ *
+ * @param other - The transaction which should be moved
+ * @param allocator - Where the transaction's inputs and outputs are stored
+ */
+Transaction::Transaction ( Transaction &&other, const allocator_type &allocator ): hash ( other.hash ), tx_index ( other.tx_index ), time ( other.time ), inputs ( std::move ( other.inputs ), allocator ), outputs ( std::move ( other.outputs ), allocator ) {}
+
 /**
  * Creates the correct outputs from the given inputs
  *
  * @param recipient - Who should recieve the transaction output
  * @param amount - The quantity fo coin which should be sent in the output
  */
-void Transaction::create_outputs ( std::string author, std::string recipient, long amount ) {
+void Transaction::create_outputs ( KeyTable::Handle author, KeyTable::Handle recipient, long amount ) {
 	
 	// Checks that the input total is enough
 	long total = 0;
-	for ( auto input : this -> inputs )
+	for ( auto &input : this -> inputs )
 		total += input.prev_out.value;
 
 	if ( total < amount )
 		throw std::runtime_error ( "Insufficient funds!" );
 
 	// Creates a new output
-	this -> outputs.push_back ( TransactionOutput ( false, author, recipient, amount, this -> tx_index ) );
+	this -> outputs.emplace_back ( false, author, recipient, amount, this -> tx_index );
 
 	if ( total - amount > 0 )
-		this -> outputs.push_back ( TransactionOutput ( false, author, author, total - amount, this -> tx_index ) );
+		this -> outputs.emplace_back ( false, author, author, total - amount, this -> tx_index );
 }
 
 /**
  * Calculates the transaction's hash
  */ 
 void Transaction::calculate_hash () {
-	this -> hash = crypto::sha256 ( this -> to_string () );
+	this -> hash = crypto::sha256 ( this -> to_bytes () );
 }
 
 /**
@@ -66,7 +92,7 @@ void Transaction::calculate_hash () {
  * @returns Whether or not the hash is valid
  */
 bool Transaction::verify_hash () {
-	return this -> hash == crypto::sha256 ( this -> to_string () );
+	return this -> hash == crypto::sha256 ( this -> to_bytes () );
 }
 
 /**
@@ -76,19 +102,34 @@ bool Transaction::verify_hash () {
  * @returns Whether or not the transaction is valid
  */ 
 bool Transaction::verify ( bool is_coinbase ) {
+	return this -> verify ( is_coinbase, true );
+}
 
-	// Verifies each transaction input
+/**
+ * Verifies whether or not the transaction is valid
+ *
+ * @param is_coinbase - Whether or not the current transaction is a coinbase
+ * @param is_signature - Whether or not the signatures should be verified (false if they were already checked separately)
+ * @returns Whether or not the transaction is valid
+ */ 
+bool Transaction::verify ( bool is_coinbase, bool is_signature ) {
+
+	// Verifies the input hashes in one batch
+	if ( !( TransactionInput::verify_hashes ( this -> inputs ) ) )
+		return false;
+
+	// Verifies each transaction input's previous output
 	long total_input = 0;
-	for ( std::vector<TransactionInput>::iterator input = this -> inputs.begin (); input != this -> inputs.end (); input++ )
-		if ( !( input -> verify ( is_coinbase ) ) )
+	for ( std::pmr::vector<TransactionInput>::iterator input = this -> inputs.begin (); input != this -> inputs.end (); input++ )
+		if ( !( input -> prev_out.verify ( is_coinbase, is_signature ) ) )
 			return false;
 		else
 			total_input += input -> prev_out.value;
 
 	// Verifies each transaction output
 	long total_output = 0;
-	for ( std::vector<TransactionOutput>::iterator output = this -> outputs.begin (); output != this -> outputs.end (); output++ ) 
-		if ( !( output -> verify ( this -> tx_index, is_coinbase ) ) )
+	for ( std::pmr::vector<TransactionOutput>::iterator output = this -> outputs.begin (); output != this -> outputs.end (); output++ ) 
+		if ( !( output -> verify ( this -> tx_index, is_coinbase, is_signature ) ) )
 			return false;
 		else
 			total_output += output -> value;	
@@ -97,6 +138,13 @@ bool Transaction::verify ( bool is_coinbase ) {
 	if ( total_input != total_output )
 		return false;	
 
+	// Verifies that every spent output belongs to the transaction's author
+	if ( !is_coinbase )
+		for ( auto &input : this -> inputs )
+			for ( auto &output : this -> outputs )
+				if ( input.prev_out.recipient != output.author )
+					return false;
+
 	// Verifies the hash
 	if ( !( this -> verify_hash () ) ) 
 		return false;
@@ -105,21 +153,128 @@ bool Transaction::verify ( bool is_coinbase ) {
 }
 
 /**
- * Converts the output into a string
+ * Runs the checks which need neither hashing nor signature checks
+ * (The inputs and outputs must be present and balance, and every spent
+ * output must belong to the author)
  *
- * @returns A string representation of the transaction output
+ * @returns Whether or not the transaction is well formed
  */
-std::string Transaction::to_string () {
-	std::ostringstream stream;
-	stream << this -> tx_index;
-	stream << this -> time.count ();
-	for ( auto input : this -> inputs ) {
-		stream << input.to_string ();
+bool Transaction::verify_structure () {
+	if ( this -> inputs.empty () || this -> outputs.empty () )
+		return false;
+
+	long total_input = 0;
+	for ( auto &input : this -> inputs )
+		total_input += input.prev_out.value;
+
+	long total_output = 0;
+	for ( auto &output : this -> outputs ) {
+		if ( output.author == KeyTable::NONE || output.recipient == KeyTable::NONE )
+			return false;
+
+		total_output += output.value;
 	}
-	for ( auto output : this -> outputs ) {
-		stream << output.to_string ( false );
+
+	if ( total_input != total_output )
+		return false;
+
+	for ( auto &input : this -> inputs )
+		for ( auto &output : this -> outputs )
+			if ( input.prev_out.recipient != output.author )
+				return false;
+
+	return true;
+}
+
+/**
+ * Verifies the signature of every spent output and every output
+ *
+ * @returns Whether or not every signature is valid
+ */
+bool Transaction::verify_signatures () {
+	for ( auto &input : this -> inputs )
+		if ( !( input.prev_out.verify_signature () ) )
+			return false;
+
+	for ( auto &output : this -> outputs )
+		if ( !( output.verify_signature () ) )
+			return false;
+
+	return true;
+}
+
+/**
+ * Writes the transaction's binary encoding
+ * (version | tx_index | time | inputs | outputs, where every input and
+ * output is length prefixed so that views can skip over them)
+ *
+ * @param writer - The writer which recieves the encoding
+ */
+void Transaction::encode ( serialize::Writer &writer ) {
+	writer.u8 ( serialize::VERSION );
+	writer.i64 ( this -> tx_index );
+	writer.i64 ( this -> time.count () );
+
+	writer.u32 ( this -> inputs.size () );
+	for ( auto &input : this -> inputs ) {
+		size_t length = writer.begin_length ();
+		input.encode ( writer );
+		writer.end_length ( length );
+	}
+
+	writer.u32 ( this -> outputs.size () );
+	for ( auto &output : this -> outputs ) {
+		size_t length = writer.begin_length ();
+		output.encode ( writer, false );
+		writer.end_length ( length );
+	}
+}
+
+/**
+ * Encodes the transaction
+ * (This is what the transaction's hash commits to)
+ *
+ * @returns The transaction's binary encoding
+ */
+std::string Transaction::to_bytes () {
+	return serialize::to_bytes ( [&] ( serialize::Writer &writer ) { this -> encode ( writer ); } );
+}
+
+/**
+ * Reads a transaction written by encode
+ * (The hash is recalculated from the bytes)
+ *
+ * @param bytes - Exactly the transaction's encoding
+ * @param allocator - Where the transaction's inputs and outputs are stored
+ * @returns The decoded transaction
+ */
+Transaction Transaction::decode ( serialize::Span bytes, const allocator_type &allocator ) {
+	serialize::Reader reader ( bytes );
+	reader.version ();
+
+	Transaction transaction ( allocator );
+	transaction.tx_index = reader.i64 ();
+	transaction.time = std::chrono::milliseconds ( reader.i64 () );
+
+	uint32_t inputs = reader.u32 ();
+	transaction.inputs.reserve ( std::min<size_t> ( inputs, reader.remaining () / 4 ) );
+	for ( uint32_t x = 0; x < inputs; x++ ) {
+		serialize::Reader input ( reader.bytes () );
+		transaction.inputs.push_back ( TransactionInput::decode ( input, allocator ) );
 	}
-	return stream.str ();
+
+	uint32_t outputs = reader.u32 ();
+	transaction.outputs.reserve ( std::min<size_t> ( outputs, reader.remaining () / 4 ) );
+	for ( uint32_t x = 0; x < outputs; x++ ) {
+		serialize::Reader output ( reader.bytes () );
+		transaction.outputs.push_back ( TransactionOutput::decode ( output, allocator ) );
+	}
+
+	if ( reader.remaining () != 0 )
+		throw std::runtime_error ( "Trailing bytes after serialized transaction!" );
+
+	transaction.hash = crypto::sha256 ( bytes.data, bytes.size );
+	return transaction;
 }
 
 /**
@@ -131,7 +286,7 @@ void Transaction::set_index ( long tx_index ) {
 	this -> tx_index = tx_index;
 	
 	// Updates the outputs
-	for ( std::vector<TransactionOutput>::iterator output = this -> outputs.begin (); output != this -> outputs.end (); output++ ) {
+	for ( std::pmr::vector<TransactionOutput>::iterator output = this -> outputs.begin (); output != this -> outputs.end (); output++ ) {
 		output -> set_index ( tx_index );
 	}
 
@@ -154,19 +309,19 @@ void Transaction::set_timestamp () {
 
 void Transaction::print ( bool is_coinbase ) {
 	std::cout << "===== TRANSACTION =====" << std::endl;
-	std::cout << "Hash: " << this -> hash << std::endl;
+	std::cout << "Hash: " << this -> hash.to_hex () << std::endl;
 	std::cout << "Hash Valid: " << this -> verify_hash () << std::endl;
 	std::cout << "Index: " << this -> tx_index << std::endl;
 	std::cout << "Timestamp: " << this -> time.count () << std::endl;
 	std::cout << "Valid: " << this -> verify ( is_coinbase ) << std::endl;
 
 	// Prints the inputs
-	for ( auto input : this -> inputs ) {
+	for ( auto &input : this -> inputs ) {
 		input.print ();
 	}
 
 	// Prints the outputs
-	for ( auto output : this -> outputs ) {
+	for ( auto &output : this -> outputs ) {
 		output.print ();
 	}
 } 
\ No newline at end of file
@@ -4,37 +4,50 @@
 
 #include <string>
 #include <vector>
+#include <memory_resource>
 #include <chrono>
 #include <sstream>
 #include <iomanip>
 #include "transaction_input.h"
 #include "transaction_output.h"
 #include "algorithms/crypto.h"
+#include "algorithms/serialize.h"
 
 class Transaction {
 	public:
-		std::string hash;
+		typedef std::pmr::polymorphic_allocator<char> allocator_type;
+
+		Hash256 hash;
 		long tx_index;
 		std::chrono::milliseconds time;
-		std::vector<TransactionInput> inputs;
-		std::vector<TransactionOutput> outputs;
+		std::pmr::vector<TransactionInput> inputs;
+		std::pmr::vector<TransactionOutput> outputs;
 
-		Transaction ( std::vector<TransactionInput> inputs, std::string author, std::string recipient, long amount );
-		Transaction ( std::vector<TransactionInput> inputs, std::vector<TransactionOutput> outputs );
+		Transaction ( std::vector<TransactionInput> inputs, KeyTable::Handle author, KeyTable::Handle recipient, long amount, const allocator_type &allocator = {} );
+		Transaction ( std::vector<TransactionInput> inputs, std::vector<TransactionOutput> outputs, const allocator_type &allocator = {} );
+		Transaction ( const Transaction &other, const allocator_type &allocator );
+		Transaction ( Transaction &&other, const allocator_type &allocator );
 		
-		void create_outputs ( std::string author, std::string recipient, long amount );
+		void create_outputs ( KeyTable::Handle author, KeyTable::Handle recipient, long amount );
 		
 		void calculate_hash ();
 		bool verify_hash ();
 		
 		bool verify ( bool is_coinbase );
+		bool verify ( bool is_coinbase, bool is_signature );
+		bool verify_structure ();
+		bool verify_signatures ();
 
-		std::string to_string ();
+		void encode ( serialize::Writer &writer );
+		std::string to_bytes ();
+		static Transaction decode ( serialize::Span bytes, const allocator_type &allocator = {} );
 		void set_index ( long tx_index );
 
 		void print ( bool is_coinbase );
 
 	private:
+		explicit Transaction ( const allocator_type &allocator );
+
 		void set_timestamp ();
 };
 
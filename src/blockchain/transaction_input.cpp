@@ -4,16 +4,41 @@
  * The transaction input constructor
  *
  * @param input
+ * @param allocator - Where the input's previous output is stored
  */
-TransactionInput::TransactionInput ( TransactionOutput input ): prev_out ( input ) {
+TransactionInput::TransactionInput ( TransactionOutput input, const allocator_type &allocator ): prev_out ( std::move ( input ), allocator ) {
 	this -> calculate_hash ();
 }
 
+/**
+ * The decoding constructor
+ * (Leaves the hash to be read from the encoding)
+ *
+ * @param allocator - Where the input's previous output is stored
+ */
+TransactionInput::TransactionInput ( const allocator_type &allocator ): prev_out ( false, KeyTable::NONE, allocator ) {}
+
+/**
+ * Copies an input into another allocator
+ *
+ * @param other - The input which should be copied
+ * @param allocator - Where the copy's previous output is stored
+ */
+TransactionInput::TransactionInput ( const TransactionInput &other, const allocator_type &allocator ): hash ( other.hash ), prev_out ( other.prev_out, allocator ) {}
+
+/**
+ * Moves an input into another allocator
+ *
+ * @param other - The input which should be moved
+ * @param allocator - Where the input's previous output is stored
+ */
+TransactionInput::TransactionInput ( TransactionInput &&other, const allocator_type &allocator ): hash ( other.hash ), prev_out ( std::move ( other.prev_out ), allocator ) {}
+
 /**
  * Calculates the input's hash
  */ 
 void TransactionInput::calculate_hash () {
-	this -> hash = crypto::sha256 ( this -> prev_out.to_string ( false ) );
+	this -> hash = crypto::sha256 ( this -> prev_out.to_bytes ( false ) );
 }
 
 /**
@@ -22,20 +47,61 @@ void TransactionInput::calculate_hash () {
  * @returns Whether or not the hash is valid
  */
 bool TransactionInput::verify_hash () {
-	return this -> hash == crypto::sha256 ( this -> prev_out.to_string ( false ) );
+	return this -> hash == crypto::sha256 ( this -> prev_out.to_bytes ( false ) );
+}
+
+/**
+ * Verifies the hash of several inputs in one batch
+ *
+ * @param inputs - The inputs whose hashes should be verified
+ * @returns Whether or not every hash is valid
+ */
+bool TransactionInput::verify_hashes ( std::pmr::vector<TransactionInput> &inputs ) {
+	std::vector<std::string> raw;
+	for ( auto &input : inputs )
+		raw.push_back ( input.prev_out.to_bytes ( false ) );
+
+	std::vector<Hash256> hashes = crypto::sha256_many ( raw );
+	for ( size_t x = 0; x < inputs.size (); x++ )
+		if ( inputs[x].hash != hashes[x] )
+			return false;
+
+	return true;
+}
+
+/**
+ * Writes the input's binary encoding
+ * (hash | prev_out)
+ *
+ * @param writer - The writer which recieves the encoding
+ */
+void TransactionInput::encode ( serialize::Writer &writer ) {
+	writer.hash ( this -> hash );
+	this -> prev_out.encode ( writer, false );
+}
+
+/**
+ * Encodes the input
+ *
+ * @returns The input's binary encoding
+ */
+std::string TransactionInput::to_bytes () {
+	return serialize::to_bytes ( [&] ( serialize::Writer &writer ) { this -> encode ( writer ); } );
 }
 
 /**
- * Converts the input into a string
- * (Should only be used for hashing)
+ * Reads an input written by encode
+ * (The stored hash is kept as is, verify_hash checks it against prev_out)
  *
- * @returns A string representation of the transaction input
+ * @param reader - The reader positioned at the input
+ * @param allocator - Where the input's previous output is stored
+ * @returns The decoded input
  */
-std::string TransactionInput::to_string () {
-	std::ostringstream stream;
-	stream << this -> hash;
-	stream << this -> prev_out.to_string ( false );
-	return stream.str ();
+TransactionInput TransactionInput::decode ( serialize::Reader &reader, const allocator_type &allocator ) {
+	TransactionInput input ( allocator );
+	input.hash = reader.hash ();
+	input.prev_out = TransactionOutput::decode ( reader, allocator );
+	return input;
 }
 
 bool TransactionInput::verify ( bool is_coinbase_input ) {
@@ -55,7 +121,7 @@ bool TransactionInput::verify ( bool is_coinbase_input ) {
 
 void TransactionInput::print () {
 	std::cout << "===== INPUT =====" << std::endl;
-	std::cout << "Hash: " << this -> hash << std::endl;
+	std::cout << "Hash: " << this -> hash.to_hex () << std::endl;
 	std::cout << "Hash valid: " << this -> verify_hash () << std::endl;
 	std::cout << "===== PREV: =====" << std::endl;
 	this -> prev_out.print ();
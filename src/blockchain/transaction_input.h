@@ -3,29 +3,41 @@
 #define TRANSACTION_INPUT_H
 
 #include <string>
+#include <vector>
+#include <memory_resource>
 #include <iomanip>
 #include <sstream>
 #include <openssl/sha.h>
 #include "transaction_output.h"
 #include "algorithms/crypto.h"
+#include "algorithms/serialize.h"
 
 class TransactionInput {
 	public:
-		std::string hash;
+		typedef std::pmr::polymorphic_allocator<char> allocator_type;
+
+		Hash256 hash;
 		TransactionOutput prev_out;
 
-		TransactionInput ( TransactionOutput input );
+		TransactionInput ( TransactionOutput input, const allocator_type &allocator = {} );
+		TransactionInput ( const TransactionInput &other, const allocator_type &allocator );
+		TransactionInput ( TransactionInput &&other, const allocator_type &allocator );
 
 		void calculate_hash ();
-		std::string to_string ();
+		void encode ( serialize::Writer &writer );
+		std::string to_bytes ();
+		static TransactionInput decode ( serialize::Reader &reader, const allocator_type &allocator = {} );
 		
 		bool verify_hash ();
+		static bool verify_hashes ( std::pmr::vector<TransactionInput> &inputs );
 		bool verify ();
 		bool verify ( bool is_coinbase_input );
 
 
 		void print ();
 
+	private:
+		explicit TransactionInput ( const allocator_type &allocator );
 };
 
 #endif
\ No newline at end of file
@@ -1,14 +1,19 @@
 #include "transaction_output.h"
 
+// Signatures which have already been verified, by ( payload hash, key hash, signature ) digest
+LruCache<Hash256, bool> TransactionOutput::signature_cache ( TransactionOutput::SIGNATURE_CACHE_SIZE );
+
 /**
  * The transaction output constructor
  *
  * @param spent - Whether or not the output has been spent
+ * @param author - The author of the output
  * @param recipient - The recipient of the output 
  * @param value - The value of the output
  * @param tx_index - The index of the output's transaction
+ * @param allocator - Where the output's signature is stored
  */
-TransactionOutput::TransactionOutput ( bool spent, std::string author, std::string recipient, long value, long tx_index ) {
+TransactionOutput::TransactionOutput ( bool spent, KeyTable::Handle author, KeyTable::Handle recipient, long value, long tx_index, const allocator_type &allocator ): signature ( allocator ) {
 	this -> spent = spent;
 	this -> author = author;
 	this -> recipient = recipient;
@@ -21,16 +26,49 @@ TransactionOutput::TransactionOutput ( bool spent, std::string author, std::stri
  *
  * @param spent - Whether or not the output has been spent
  * @param recipient - The output recipient
+ * @param allocator - Where the output's signature is stored
  */
-TransactionOutput::TransactionOutput ( bool spent, std::string recipient ) {
+TransactionOutput::TransactionOutput ( bool spent, KeyTable::Handle recipient, const allocator_type &allocator ): signature ( allocator ) {
 	this -> spent = spent;
+	this -> author = KeyTable::NONE;
 	this -> recipient = recipient;
 	this -> value = 0;
 	this -> tx_index = 0; 
 }
 
+/**
+ * Copies an output into another allocator
+ * (Used by pmr containers, so that a whole block's outputs share its arena)
+ *
+ * @param other - The output which should be copied
+ * @param allocator - Where the copy's signature is stored
+ */
+TransactionOutput::TransactionOutput ( const TransactionOutput &other, const allocator_type &allocator ): signature ( other.signature, allocator ) {
+	this -> tx_index = other.tx_index;
+	this -> value = other.value;
+	this -> spent = other.spent;
+	this -> author = other.author;
+	this -> recipient = other.recipient;
+}
+
+/**
+ * Moves an output into another allocator
+ * (Only steals the signature if both allocators use the same resource)
+ *
+ * @param other - The output which should be moved
+ * @param allocator - Where the output's signature is stored
+ */
+TransactionOutput::TransactionOutput ( TransactionOutput &&other, const allocator_type &allocator ): signature ( std::move ( other.signature ), allocator ) {
+	this -> tx_index = other.tx_index;
+	this -> value = other.value;
+	this -> spent = other.spent;
+	this -> author = other.author;
+	this -> recipient = other.recipient;
+}
+
 /**
  * Verifies the output's signature
+ * (A signature which has already been verified once isn't checked again)
  *
  * @returns Whether or not the signature is valid
  */
@@ -40,15 +78,28 @@ bool TransactionOutput::verify_signature () {
 	if ( this -> signature.empty () )
 		throw std::runtime_error ( "This transaction hasn't been signed yet!" );
 
-	// Creates the verification context
-	EVP_MD_CTX* context = EVP_MD_CTX_create ();
-	if ( EVP_DigestVerifyInit ( context, NULL, EVP_sha256 (), NULL, this -> get_author () ) != 1 )
-		throw std::runtime_error ( "Failed to verify transaction signature!" );
+	std::string payload = this -> to_bytes ( true );
+
+	// Checks whether this exact ( payload, key, signature ) triple was already verified
+	Hash256 triple[2] = { crypto::sha256 ( payload ), KeyTable::global ().id ( this -> author ) };
+	std::string entry ( reinterpret_cast<const char*> ( triple ), sizeof ( triple ) );
+	entry.append ( this -> signature );
 
-	if ( EVP_DigestVerifyUpdate ( context, (const unsigned char*) this -> to_string ( true ).c_str (), this -> to_string ( true ).length () ) != 1 )
+	Hash256 entry_hash = crypto::sha256 ( entry );
+	if ( signature_cache.contains ( entry_hash ) )
+		return true;
+
+	std::shared_ptr<EVP_PKEY> author = this -> get_author ();
+	if ( !author )
 		throw std::runtime_error ( "Failed to verify transaction signature!" );
 
-	return EVP_DigestVerifyFinal ( context, (const unsigned char*) crypto::from_hex ( this -> signature ).c_str (), crypto::from_hex ( this -> signature ).length () );
+	// Verifies the signature with the scheme matching the author's key
+	std::string signature ( this -> signature.begin (), this -> signature.end () );
+	if ( !crypto::SignatureScheme::for_key ( author.get () ) -> verify ( author.get (), payload, signature ) )
+		return false;
+
+	signature_cache.put ( entry_hash, true );
+	return true;
 }
 
 /**
@@ -58,19 +109,30 @@ bool TransactionOutput::verify_signature () {
  * @returns Whether or not the output is valid
  */
 bool TransactionOutput::verify ( bool is_coinbase_output ) {
+	return this -> verify ( is_coinbase_output, true );
+}
+
+/**
+ * Verifies whether or not the transaction output is valid
+ *
+ * @param is_coinbase_output - Whether or not the parent transaction is a coinbase
+ * @param is_signature - Whether or not the signature should be verified (false if it was already checked separately)
+ * @returns Whether or not the output is valid
+ */
+bool TransactionOutput::verify ( bool is_coinbase_output, bool is_signature ) {
 
 	if ( !is_coinbase_output ) {
 		
 		// Verifies the signature
-		if ( !( this -> verify_signature () ) )
+		if ( is_signature && !( this -> verify_signature () ) )
 			return false;
 
 		// Verifies that the author is present
-		if ( this -> author.empty () ) 
+		if ( this -> author == KeyTable::NONE ) 
 			return false;
 
 		// Verifies that the recipient is present
-		if ( this -> recipient.empty () )
+		if ( this -> recipient == KeyTable::NONE )
 			return false;
 
 		return true;
@@ -81,11 +143,11 @@ bool TransactionOutput::verify ( bool is_coinbase_output ) {
 		return false;
 
 	// Verifies that the author isn't present
-	if ( !( this -> author.empty () ) )
+	if ( this -> author != KeyTable::NONE )
 		return false;
 
 	// Verifies that the recipient is present
-	if ( this -> recipient.empty () )
+	if ( this -> recipient == KeyTable::NONE )
 		return false;
 
 	return true;
@@ -99,11 +161,23 @@ bool TransactionOutput::verify ( bool is_coinbase_output ) {
  * @returns Whether or not the output is valid
  */
 bool TransactionOutput::verify ( long tx_index, bool is_coinbase_output ) {
+	return this -> verify ( tx_index, is_coinbase_output, true );
+}
+
+/**
+ * Verifies whether or not the transaction output is valid
+ *
+ * @param tx_index - The index of the output's transaction
+ * @param is_coinbase_output - Whether or not the parent transaction is a coinbase
+ * @param is_signature - Whether or not the signature should be verified (false if it was already checked separately)
+ * @returns Whether or not the output is valid
+ */
+bool TransactionOutput::verify ( long tx_index, bool is_coinbase_output, bool is_signature ) {
 
 	if ( !is_coinbase_output ){
 		
 		// Verifies the signature
-		if ( !( this -> verify_signature () ) )
+		if ( is_signature && !( this -> verify_signature () ) )
 			return false;
 
 		// Verifies the transaction index
@@ -111,11 +185,11 @@ bool TransactionOutput::verify ( long tx_index, bool is_coinbase_output ) {
 			return false;
 
 		// Verifies that the author is present
-		if ( this -> author.empty () ) 
+		if ( this -> author == KeyTable::NONE ) 
 			return false;
 
 		// Verifies that the recipient is present
-		if ( this -> recipient.empty () )
+		if ( this -> recipient == KeyTable::NONE )
 			return false;
 
 		return true;
@@ -126,30 +200,72 @@ bool TransactionOutput::verify ( long tx_index, bool is_coinbase_output ) {
 		return false;
 
 	// Verifies that the recipient is present
-	if ( this -> recipient.empty () )
+	if ( this -> recipient == KeyTable::NONE )
 		return false;
 
 	return true;
 }
 
 /**
- * Converts the output into a string
- * (Should only be used for hashing)
+ * Writes the output's binary encoding
+ * (signature | tx_index | value | spent | author | recipient, where everything
+ * after the tx_index is what gets signed and both keys are written as key IDs)
+ *
+ * @param writer - The writer which recieves the encoding
+ * @param is_signature - Whether or not to only write the signed payload
+ */
+void TransactionOutput::encode ( serialize::Writer &writer, bool is_signature ) {
+	if ( !is_signature ) {
+		writer.bytes ( this -> signature.data (), this -> signature.size () );
+		writer.i64 ( this -> tx_index );
+	}
+
+	writer.i64 ( this -> value );
+	writer.u8 ( this -> spent );
+	writer.hash ( KeyTable::global ().id ( this -> author ) );
+	writer.hash ( KeyTable::global ().id ( this -> recipient ) );
+}
+
+/**
+ * Encodes the output
+ * (This is what the output's hash and signature commit to)
+ *
+ * @param is_signature - Whether or not to only encode the signed payload
+ * @returns The output's binary encoding
+ */
+std::string TransactionOutput::to_bytes ( bool is_signature ) {
+	return serialize::to_bytes ( [&] ( serialize::Writer &writer ) { this -> encode ( writer, is_signature ); } );
+}
+
+/**
+ * Gets the output's outpoint, which is how it's identified once it's mined
+ * (The same hash as a TransactionInput spending this output)
+ *
+ * @returns The hash of the output's encoding
+ */
+Hash256 TransactionOutput::outpoint () {
+	return crypto::sha256 ( this -> to_bytes ( false ) );
+}
+
+/**
+ * Reads an output written by encode
+ * (Keys are interned by ID, their PEMs come from whoever shipped the output)
  *
- * @param is_signature - Whether or not to this will be signed
- * @returns A string representation of the transaction output
+ * @param reader - The reader positioned at the output
+ * @param allocator - Where the output's signature is stored
+ * @returns The decoded output
  */
-std::string TransactionOutput::to_string ( bool is_signature ) {
-	std::ostringstream stream;
-	
-	if ( !is_signature ) 
-		stream << this -> signature << this -> tx_index;
-	
-	stream << this -> value;
-	stream << this -> spent;
-	stream << this -> author;
-	stream << this -> recipient;
-	return stream.str ();
+TransactionOutput TransactionOutput::decode ( serialize::Reader &reader, const allocator_type &allocator ) {
+	serialize::Span signature = reader.bytes ();
+	long tx_index = reader.i64 ();
+	long value = reader.i64 ();
+	bool spent = reader.u8 () != 0;
+	KeyTable::Handle author = KeyTable::global ().intern ( reader.hash () );
+	KeyTable::Handle recipient = KeyTable::global ().intern ( reader.hash () );
+
+	TransactionOutput output ( spent, author, recipient, value, tx_index, allocator );
+	output.signature.assign ( reinterpret_cast<const char*> ( signature.data ), signature.size );
+	return output;
 }
 
 /**
@@ -163,14 +279,12 @@ void TransactionOutput::set_index ( long tx_index ) {
 
 /**
  * Gets the transaction author as an EVP_PKEY
+ * (Each distinct key is only parsed once, by the key table)
  *
- * @returns The author's public key
+ * @returns The author's public key (empty if the PEM is unknown or invalid)
  */ 
-EVP_PKEY* TransactionOutput::get_author () {
-	
-	// Creates a new IO buffer
-	BIO *bio = BIO_new_mem_buf ( this -> author.c_str (), this -> author.length () );
-	return PEM_read_bio_PUBKEY ( bio, NULL, NULL, NULL );
+std::shared_ptr<EVP_PKEY> TransactionOutput::get_author () {
+	return KeyTable::global ().key ( this -> author );
 }
 
 
@@ -179,10 +293,10 @@ EVP_PKEY* TransactionOutput::get_author () {
 
 void TransactionOutput::print () {
 	std::cout << "===== OUTPUT =====" << std::endl;
-	std::cout << "Sig: " << this -> signature << std::endl;
+	std::cout << "Sig: " << crypto::to_hex ( std::string ( this -> signature.begin (), this -> signature.end () ) ) << std::endl;
 	std::cout << "Index: " << this -> tx_index << std::endl;
 	std::cout << "Value: " << this -> value << std::endl;
 	std::cout << "Spent: " << this -> spent << std::endl;
-	std::cout << "Author: " << this -> author << std::endl;
-	std::cout << "Recipient: " << this -> recipient << std::endl; 
+	std::cout << "Author: " << KeyTable::global ().id ( this -> author ).to_hex () << std::endl;
+	std::cout << "Recipient: " << KeyTable::global ().id ( this -> recipient ).to_hex () << std::endl; 
 }
@@ -6,33 +6,51 @@
 #include <iostream>
 #include <sstream>
 #include <iomanip>
+#include <memory>
+#include <memory_resource>
 #include <openssl/evp.h>
-#include <openssl/bio.h>
-#include <openssl/pem.h>
+#include "key_table.h"
 #include "algorithms/crypto.h"
+#include "algorithms/lru_cache.h"
+#include "algorithms/signature.h"
+#include "algorithms/serialize.h"
 
 class TransactionOutput {
 	public:
-		std::string signature;
+		static const size_t SIGNATURE_CACHE_SIZE = 1 << 16;
+
+		typedef std::pmr::polymorphic_allocator<char> allocator_type;
+
+		std::pmr::string signature;
 		long tx_index;
 		long value;
 		bool spent;
-		std::string author;
-		std::string recipient;
+		KeyTable::Handle author;
+		KeyTable::Handle recipient;
 
-		TransactionOutput ( bool spent, std::string author, std::string recipient, long value, long tx_index );
-		TransactionOutput ( bool spent, std::string recipient );
+		TransactionOutput ( bool spent, KeyTable::Handle author, KeyTable::Handle recipient, long value, long tx_index, const allocator_type &allocator = {} );
+		TransactionOutput ( bool spent, KeyTable::Handle recipient, const allocator_type &allocator = {} );
+		TransactionOutput ( const TransactionOutput &other, const allocator_type &allocator );
+		TransactionOutput ( TransactionOutput &&other, const allocator_type &allocator );
 
 		bool verify_signature ();
 		bool verify ( bool is_coinbase_output );
+		bool verify ( bool is_coinbase_output, bool is_signature );
 		bool verify ( long tx_index, bool is_coinbase_output );
+		bool verify ( long tx_index, bool is_coinbase_output, bool is_signature );
 
-		std::string to_string ( bool is_signature );
+		void encode ( serialize::Writer &writer, bool is_signature );
+		std::string to_bytes ( bool is_signature );
+		Hash256 outpoint ();
+		static TransactionOutput decode ( serialize::Reader &reader, const allocator_type &allocator = {} );
 		void set_index ( long tx_index );
-		EVP_PKEY *get_author ();
+		std::shared_ptr<EVP_PKEY> get_author ();
 
 		void print ();
 
+	private:
+		static LruCache<Hash256, bool> signature_cache;
+
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,84 @@
+#include "tx_index.h"
+
+/**
+ * The transaction index constructor
+ */
+TxIndex::TxIndex () {}
+
+/**
+ * Indexes every transaction in a stored block
+ *
+ * @param height - The block's position in the chain
+ * @param block - A view of the stored block
+ */
+void TxIndex::add_block ( size_t height, BlockView block ) {
+	if ( block.index () != (long) this -> by_index.size () )
+		throw std::runtime_error ( "Attempted indexing a block out of order!" );
+
+	serialize::Reader reader ( block.bytes () );
+	reader.skip ( BlockView::TRANSACTIONS_OFFSET + 4 );
+
+	for ( size_t position = 0; position < block.transaction_count (); position++ ) {
+		uint32_t size = reader.u32 ();
+		uint32_t offset = reader.position ();
+		serialize::Span bytes = reader.raw ( size );
+
+		this -> by_hash[crypto::sha256 ( bytes.data, bytes.size )] = this -> by_index.size ();
+		this -> by_index.push_back ( TxLocation { (uint32_t) height, (uint32_t) position, offset, size } );
+	}
+}
+
+/**
+ * Removes a block's transactions, which must be the last ones indexed
+ *
+ * @param block - A view of the stored block
+ */
+void TxIndex::remove_block ( BlockView block ) {
+	if ( block.index () + (long) block.transaction_count () != (long) this -> by_index.size () )
+		throw std::runtime_error ( "Attempted removing a block out of order!" );
+
+	for ( TransactionView transaction : block )
+		this -> by_hash.erase ( transaction.hash () );
+
+	this -> by_index.resize ( block.index () );
+}
+
+void TxIndex::clear () {
+	this -> by_index.clear ();
+	this -> by_hash.clear ();
+}
+
+/**
+ * Finds a transaction by hash
+ *
+ * @param hash - The transaction's hash
+ * @param location - Recieves the transaction's location
+ * @returns Whether or not the transaction is in the chain
+ */
+bool TxIndex::find ( const Hash256 &hash, TxLocation &location ) const {
+	auto entry = this -> by_hash.find ( hash );
+	if ( entry == this -> by_hash.end () )
+		return false;
+
+	location = this -> by_index[entry -> second];
+	return true;
+}
+
+/**
+ * Finds a transaction by index
+ *
+ * @param tx_index - The transaction's index
+ * @param location - Recieves the transaction's location
+ * @returns Whether or not the transaction is in the chain
+ */
+bool TxIndex::find ( long tx_index, TxLocation &location ) const {
+	if ( tx_index < 0 || tx_index >= (long) this -> by_index.size () )
+		return false;
+
+	location = this -> by_index[tx_index];
+	return true;
+}
+
+size_t TxIndex::size () const {
+	return this -> by_index.size ();
+}
@@ -0,0 +1,44 @@
+#pragma once
+#ifndef TX_INDEX_H
+#define TX_INDEX_H
+
+#include <vector>
+#include <cstdint>
+#include <unordered_map>
+#include "views.h"
+#include "algorithms/hash256.h"
+#include "algorithms/serialize.h"
+
+/**
+ * Where a transaction's encoding lives inside its stored block
+ */
+struct TxLocation {
+	uint32_t height;
+	uint32_t position;
+	uint32_t offset;
+	uint32_t size;
+};
+
+/**
+ * Maps transaction hashes and indexes to their location in the chain
+ * (Transaction indexes are contiguous from the genesis block, so they index
+ * straight into a vector; hashes map to a transaction index)
+ */
+class TxIndex {
+	public:
+		TxIndex ();
+
+		void add_block ( size_t height, BlockView block );
+		void remove_block ( BlockView block );
+		void clear ();
+
+		bool find ( const Hash256 &hash, TxLocation &location ) const;
+		bool find ( long tx_index, TxLocation &location ) const;
+		size_t size () const;
+
+	private:
+		std::vector<TxLocation> by_index;
+		std::unordered_map<Hash256, long> by_hash;
+};
+
+#endif
@@ -0,0 +1,96 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cstdlib>
+#include <cstdint>
+#include <utility>
+#include <cstring>
+#include <algorithm>
+#include <unordered_map>
+#include "utxo_set.h"
+#include "algorithms/hash256.h"
+
+/**
+ * Derives a uniformly distributed outpoint from a number, so no keys need storing
+ *
+ * @param seed - The number
+ * @returns The outpoint
+ */
+static Hash256 outpoint ( uint64_t seed ) {
+	Hash256 hash;
+	for ( size_t word = 0; word < 4; word++ ) {
+		uint64_t value = seed * 4 + word + 0x9E3779B97F4A7C15ULL;
+		value = ( value ^ ( value >> 30 ) ) * 0xBF58476D1CE4E5B9ULL;
+		value = ( value ^ ( value >> 27 ) ) * 0x94D049BB133111EBULL;
+		value ^= value >> 31;
+		std::memcpy ( hash.bytes + 8 * word, &value, 8 );
+	}
+
+	return hash;
+}
+
+/**
+ * Times a pass over count keys
+ *
+ * @param count - The number of keys
+ * @param run - Called with each key's number
+ * @returns The mean time per key in nanoseconds
+ */
+template <typename Run>
+static double measure ( uint64_t count, Run run ) {
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now ();
+	for ( uint64_t x = 0; x < count; x++ )
+		run ( x );
+
+	return std::chrono::duration<double, std::nano> ( std::chrono::steady_clock::now () - start ).count () / count;
+}
+
+/**
+ * Benchmarks the UTXO set against std::unordered_map
+ * (Run with the number of outputs, 10M by default: every output is added,
+ * then looked up in a scattered order, looked up while missing, and removed)
+ */
+int main ( int argc, char **argv ) {
+	uint64_t count = argc > 1 ? std::strtoull ( argv[1], nullptr, 10 ) : 10000000;
+	uint64_t lookups = std::min<uint64_t> ( count, 2000000 );
+	uint64_t misses = 0;
+
+	// Picks added keys in a scattered order, so lookups miss the cache like real spends
+	auto scattered = [count] ( uint64_t x ) { return ( x * 0x9E3779B1ULL ) % count; };
+
+	std::cout << std::left << std::setw ( 16 ) << "table" << std::right << std::setw ( 12 ) << "insert (ns)" << std::setw ( 10 ) << "hit (ns)" << std::setw ( 11 ) << "miss (ns)" << std::setw ( 13 ) << "remove (ns)" << std::setw ( 14 ) << "memory (MB)" << std::endl;
+	std::cout << std::fixed << std::setprecision ( 1 );
+
+	{
+		UtxoSet utxos;
+		double insert = measure ( count, [&] ( uint64_t x ) { utxos.add ( outpoint ( x ), (int64_t) x ); } );
+		double memory = utxos.memory_usage () / 1e6;
+
+		int64_t value;
+		uint32_t copies;
+		double hit = measure ( lookups, [&] ( uint64_t x ) { misses += !( utxos.find ( outpoint ( scattered ( x ) ), value, copies ) ); } );
+		double miss = measure ( lookups, [&] ( uint64_t x ) { misses += utxos.contains ( outpoint ( count + x ) ); } );
+		double remove = measure ( count, [&] ( uint64_t x ) { misses += !( utxos.remove ( outpoint ( x ) ) ); } );
+
+		std::cout << std::left << std::setw ( 16 ) << "UtxoSet" << std::right << std::setw ( 12 ) << insert << std::setw ( 10 ) << hit << std::setw ( 11 ) << miss << std::setw ( 13 ) << remove << std::setw ( 14 ) << memory << std::endl;
+	}
+
+	{
+		std::unordered_map<Hash256, std::pair<int64_t, uint32_t>> utxos;
+		double insert = measure ( count, [&] ( uint64_t x ) { utxos.emplace ( outpoint ( x ), std::make_pair ( (int64_t) x, 1u ) ); } );
+
+		// Nodes, plus the bucket array
+		double memory = ( utxos.size () * ( sizeof ( void* ) + sizeof ( size_t ) + sizeof ( std::pair<const Hash256, std::pair<int64_t, uint32_t>> ) ) + utxos.bucket_count () * sizeof ( void* ) ) / 1e6;
+
+		double hit = measure ( lookups, [&] ( uint64_t x ) { misses += utxos.find ( outpoint ( scattered ( x ) ) ) == utxos.end (); } );
+		double miss = measure ( lookups, [&] ( uint64_t x ) { misses += utxos.count ( outpoint ( count + x ) ); } );
+		double remove = measure ( count, [&] ( uint64_t x ) { misses += utxos.erase ( outpoint ( x ) ) == 0; } );
+
+		std::cout << std::left << std::setw ( 16 ) << "unordered_map" << std::right << std::setw ( 12 ) << insert << std::setw ( 10 ) << hit << std::setw ( 11 ) << miss << std::setw ( 13 ) << remove << std::setw ( 14 ) << memory << std::endl;
+	}
+
+	if ( misses != 0 )
+		std::cout << "Unexpected lookup results: " << misses << std::endl;
+
+	return misses == 0 ? 0 : 1;
+}
@@ -0,0 +1,174 @@
+#include "utxo_set.h"
+
+/**
+ * The UTXO set constructor
+ */
+UtxoSet::UtxoSet () {
+	this -> entries = 0;
+	this -> slots.assign ( MIN_CAPACITY, Entry {} );
+}
+
+/**
+ * Gets a key's home slot
+ * (Outpoints are digests, so their first bytes are already uniformly distributed)
+ *
+ * @param key - The outpoint's first KEY_SIZE bytes
+ * @returns The slot where probing starts
+ */
+size_t UtxoSet::slot ( const unsigned char *key ) const {
+	uint64_t bits;
+	std::memcpy ( &bits, key, sizeof ( bits ) );
+	return bits & ( this -> slots.size () - 1 );
+}
+
+/**
+ * Finds a key's slot
+ *
+ * @param key - The outpoint's first KEY_SIZE bytes
+ * @returns The slot holding the key, or the empty slot where it would go
+ */
+size_t UtxoSet::locate ( const unsigned char *key ) const {
+	size_t mask = this -> slots.size () - 1;
+	size_t position = this -> slot ( key );
+
+	while ( this -> slots[position].count != 0 && std::memcmp ( this -> slots[position].key, key, KEY_SIZE ) != 0 )
+		position = ( position + 1 ) & mask;
+
+	return position;
+}
+
+/**
+ * Checks whether an output is unspent
+ *
+ * @param outpoint - The output's outpoint
+ * @returns Whether or not the output is in the set
+ */
+bool UtxoSet::contains ( const Hash256 &outpoint ) const {
+	return this -> slots[this -> locate ( outpoint.bytes )].count != 0;
+}
+
+/**
+ * Looks up an unspent output
+ *
+ * @param outpoint - The output's outpoint
+ * @param value - Recieves the output's value
+ * @param count - Recieves the number of identical unspent outputs
+ * @returns Whether or not the output is in the set
+ */
+bool UtxoSet::find ( const Hash256 &outpoint, int64_t &value, uint32_t &count ) const {
+	const Entry &found = this -> slots[this -> locate ( outpoint.bytes )];
+	if ( found.count == 0 )
+		return false;
+
+	value = found.value;
+	count = found.count;
+	return true;
+}
+
+/**
+ * Adds an unspent output
+ *
+ * @param outpoint - The output's outpoint
+ * @param value - The output's value
+ */
+void UtxoSet::add ( const Hash256 &outpoint, int64_t value ) {
+
+	// Keeps the load factor under 3/4
+	if ( 4 * ( this -> entries + 1 ) > 3 * this -> slots.size () )
+		this -> resize ( 2 * this -> slots.size () );
+
+	Entry &entry = this -> slots[this -> locate ( outpoint.bytes )];
+	if ( entry.count != 0 ) {
+		entry.count++;
+		return;
+	}
+
+	std::memcpy ( entry.key, outpoint.bytes, KEY_SIZE );
+	entry.count = 1;
+	entry.value = value;
+	this -> entries++;
+}
+
+/**
+ * Spends an output
+ *
+ * @param outpoint - The output's outpoint
+ * @returns Whether or not the output was unspent
+ */
+bool UtxoSet::remove ( const Hash256 &outpoint ) {
+	size_t mask = this -> slots.size () - 1;
+	size_t hole = this -> locate ( outpoint.bytes );
+	if ( this -> slots[hole].count == 0 )
+		return false;
+
+	if ( --this -> slots[hole].count != 0 )
+		return true;
+
+	// Shifts back every following entry which would no longer be reachable
+	this -> entries--;
+	for ( size_t position = ( hole + 1 ) & mask; this -> slots[position].count != 0; position = ( position + 1 ) & mask ) {
+		size_t home = this -> slot ( this -> slots[position].key );
+		if ( ( ( position - home ) & mask ) >= ( ( position - hole ) & mask ) ) {
+			this -> slots[hole] = this -> slots[position];
+			hole = position;
+		}
+	}
+
+	this -> slots[hole] = Entry {};
+	return true;
+}
+
+/**
+ * Grows the table ahead of a known number of outputs
+ *
+ * @param count - The number of outputs the set should hold without resizing
+ */
+void UtxoSet::reserve ( size_t count ) {
+	size_t capacity = this -> slots.size ();
+	while ( 3 * capacity < 4 * count )
+		capacity *= 2;
+
+	if ( capacity != this -> slots.size () )
+		this -> resize ( capacity );
+}
+
+void UtxoSet::clear () {
+	this -> entries = 0;
+	this -> slots.assign ( MIN_CAPACITY, Entry {} );
+}
+
+/**
+ * Rehashes every entry into a new table
+ *
+ * @param capacity - The new number of slots (a power of two)
+ */
+void UtxoSet::resize ( size_t capacity ) {
+	std::vector<Entry> previous ( capacity, Entry {} );
+	previous.swap ( this -> slots );
+
+	for ( auto &entry : previous )
+		if ( entry.count != 0 )
+			this -> slots[this -> locate ( entry.key )] = entry;
+}
+
+/**
+ * Gets the number of distinct unspent outputs
+ *
+ * @returns The number of entries
+ */
+size_t UtxoSet::size () const {
+	return this -> entries;
+}
+
+size_t UtxoSet::capacity () const {
+	return this -> slots.size ();
+}
+
+/**
+ * Gets the memory held by the table
+ *
+ * @returns The table's size in bytes
+ */
+size_t UtxoSet::memory_usage () const {
+	return this -> slots.capacity () * sizeof ( Entry );
+}
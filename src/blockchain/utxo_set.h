@@ -0,0 +1,72 @@
+#pragma once
+#ifndef UTXO_SET_H
+#define UTXO_SET_H
+
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include "algorithms/hash256.h"
+
+/**
+ * An output spent by a block, with what's needed to make it unspent again
+ */
+struct SpentOutput {
+	Hash256 outpoint;
+	int64_t value;
+};
+
+/**
+ * How a block changed the UTXO set, so that it can be disconnected without
+ * replaying the chain
+ */
+struct UndoRecord {
+	std::vector<SpentOutput> spent;
+	std::vector<Hash256> created;
+};
+
+/**
+ * The set of unspent outputs, keyed by outpoint (the hash of the output's
+ * encoding, which is what a TransactionInput's hash commits to)
+ * (An open addressing hash table: linear probing over a power of two table
+ * of 32 byte entries, with backward shift deletion so no tombstones build up.
+ * Entries keep the first 160 bits of the outpoint, and identical outputs
+ * share one entry and are counted)
+ */
+class UtxoSet {
+	public:
+		static const size_t MIN_CAPACITY = 1024;
+		static const size_t KEY_SIZE = 20;
+
+		UtxoSet ();
+
+		bool contains ( const Hash256 &outpoint ) const;
+		bool find ( const Hash256 &outpoint, int64_t &value, uint32_t &count ) const;
+		void add ( const Hash256 &outpoint, int64_t value );
+		bool remove ( const Hash256 &outpoint );
+
+		void reserve ( size_t count );
+		void clear ();
+
+		size_t size () const;
+		size_t capacity () const;
+		size_t memory_usage () const;
+
+	private:
+		struct Entry {
+			unsigned char key[KEY_SIZE];
+			uint32_t count;
+			int64_t value;
+		};
+
+		std::vector<Entry> slots;
+		size_t entries;
+
+		size_t slot ( const unsigned char *key ) const;
+		size_t locate ( const unsigned char *key ) const;
+		void resize ( size_t capacity );
+};
+
+static_assert ( UtxoSet::KEY_SIZE + sizeof ( uint32_t ) + sizeof ( int64_t ) == 32, "UTXO entries must stay 32 bytes" );
+
+#endif
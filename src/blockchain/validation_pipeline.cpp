@@ -0,0 +1,345 @@
+#include "validation_pipeline.h"
+
+/**
+ * The pipeline constructor (checks signatures on every available core)
+ *
+ * @param chain - The chain which accepted blocks and transactions are committed to
+ */
+ValidationPipeline::ValidationPipeline ( Blockchain &chain ): ValidationPipeline ( chain, std::thread::hardware_concurrency () ) {}
+
+/**
+ * The pipeline constructor
+ * (Signature checks get every thread, hashing half of them and the other
+ * stages one each)
+ *
+ * @param chain - The chain which accepted blocks and transactions are committed to
+ * @param threads - The number of signature workers
+ */
+ValidationPipeline::ValidationPipeline ( Blockchain &chain, unsigned int threads ): ValidationPipeline ( chain, std::array<StageConfig, STAGES> { {
+	{ 1, DEFAULT_CAPACITY },
+	{ 1, DEFAULT_CAPACITY },
+	{ std::max ( threads / 2, 1u ), DEFAULT_CAPACITY },
+	{ std::max ( threads, 1u ), DEFAULT_CAPACITY },
+	{ 1, DEFAULT_CAPACITY }
+} } ) {}
+
+/**
+ * The pipeline constructor
+ *
+ * @param chain - The chain which accepted blocks and transactions are committed to
+ * @param config - Each stage's worker count and queue capacity (the commit stage always has a single worker)
+ */
+ValidationPipeline::ValidationPipeline ( Blockchain &chain, std::array<StageConfig, STAGES> config ): chain ( chain ) {
+	this -> stopped = false;
+	this -> submitted = 0;
+	this -> finished = 0;
+
+	for ( int stage = 0; stage < STAGES; stage++ )
+		this -> stages[stage] = std::make_unique<StageState> ( config[stage].capacity );
+
+	// Starts the workers
+	for ( int stage = 0; stage < STAGES; stage++ ) {
+		unsigned int workers = stage == COMMIT ? 1 : std::max ( config[stage].workers, 1u );
+		for ( unsigned int worker = 0; worker < workers; worker++ )
+			this -> stages[stage] -> workers.emplace_back ( &ValidationPipeline::run, this, (Stage) stage );
+	}
+}
+
+ValidationPipeline::~ValidationPipeline () {
+	this -> stop ();
+}
+
+ValidationPipeline::StageState::StageState ( size_t capacity ): queue ( capacity ) {
+	this -> max_depth = 0;
+	this -> processed = 0;
+	this -> rejected = 0;
+	this -> wait_time = 0;
+	this -> work_time = 0;
+}
+
+/**
+ * Submits an encoded block, waiting while the decode queue is full
+ *
+ * @param bytes - The block's encoding
+ * @returns The submission's sequence number (submissions are numbered in the order drain () reports them)
+ */
+uint64_t ValidationPipeline::submit_block ( std::string bytes ) {
+	return this -> submit ( std::move ( bytes ), true );
+}
+
+/**
+ * Submits an encoded transaction, waiting while the decode queue is full
+ *
+ * @param bytes - The transaction's encoding
+ * @returns The submission's sequence number (submissions are numbered in the order drain () reports them)
+ */
+uint64_t ValidationPipeline::submit_transaction ( std::string bytes ) {
+	return this -> submit ( std::move ( bytes ), false );
+}
+
+/**
+ * Waits until every submission so far has been committed or rejected
+ * (The outcomes are handed over, so the pipeline only ever holds the ones which haven't been drained yet)
+ *
+ * @returns The outcome of every submission since the last drain, in submission order
+ */
+std::vector<SubmitResult> ValidationPipeline::drain () {
+	std::unique_lock<std::mutex> lock ( this -> mutex );
+	this -> committed.wait ( lock, [this] () { return this -> finished == this -> submitted; } );
+
+	std::vector<SubmitResult> results;
+	results.swap ( this -> results );
+	return results;
+}
+
+/**
+ * Finishes every submission, then stops the workers
+ * (Each stage is closed once the stage before it has stopped, so nothing in
+ * flight is lost)
+ */
+void ValidationPipeline::stop () {
+	{
+		std::lock_guard<std::mutex> lock ( this -> mutex );
+		if ( this -> stopped )
+			return;
+
+		this -> stopped = true;
+	}
+
+	for ( int stage = 0; stage < STAGES; stage++ ) {
+		this -> stages[stage] -> queue.close ();
+		for ( auto &worker : this -> stages[stage] -> workers )
+			worker.join ();
+	}
+}
+
+/**
+ * Gets every stage's counters
+ * (Latencies are means in microseconds: the wait is the time a submission
+ * spent in the stage's queue, the work the time the stage spent on it)
+ *
+ * @returns The counters, one entry per stage
+ */
+std::vector<ValidationPipeline::StageStats> ValidationPipeline::stats () {
+	std::vector<StageStats> stats;
+	for ( int stage = 0; stage < STAGES; stage++ ) {
+		StageState &state = *( this -> stages[stage] );
+		uint64_t processed = state.processed.load ();
+		double count = processed == 0 ? 1 : (double) processed;
+
+		stats.push_back ( StageStats {
+			stage_name ( (Stage) stage ),
+			state.queue.size (),
+			state.max_depth.load (),
+			processed,
+			state.rejected.load (),
+			state.wait_time.load () / count / 1000.0,
+			state.work_time.load () / count / 1000.0
+		} );
+	}
+
+	return stats;
+}
+
+std::string ValidationPipeline::stage_name ( Stage stage ) {
+	switch ( stage ) {
+		case DECODE: return "decode";
+		case STRUCTURE: return "structure";
+		case HASHES: return "hashes";
+		case SIGNATURES: return "signatures";
+		case COMMIT: return "commit";
+		default: return "";
+	}
+}
+
+/**
+ * Hands a submission to the first stage
+ * (Submissions are queued one at a time, and the sequence number is only
+ * taken once the submission is queued: if stop () closes the queue first,
+ * nothing is left for drain () to wait on)
+ *
+ * @param bytes - The encoding
+ * @param is_block - Whether the encoding is a block or a transaction
+ * @returns The submission's sequence number
+ */
+uint64_t ValidationPipeline::submit ( std::string bytes, bool is_block ) {
+	auto job = std::make_unique<Job> ();
+	job -> is_block = is_block;
+	job -> bytes = std::move ( bytes );
+
+	std::lock_guard<std::mutex> queueing ( this -> submitting );
+	{
+		std::lock_guard<std::mutex> lock ( this -> mutex );
+		if ( this -> stopped )
+			throw std::runtime_error ( "Attempted submitting to a stopped validation pipeline!" );
+
+		job -> sequence = this -> submitted;
+	}
+
+	uint64_t sequence = job -> sequence;
+	this -> enqueue ( DECODE, std::move ( job ) );
+
+	{
+		std::lock_guard<std::mutex> lock ( this -> mutex );
+		this -> submitted++;
+	}
+
+	this -> committed.notify_all ();
+	return sequence;
+}
+
+/**
+ * Queues a submission for a stage, waiting while the stage's queue is full
+ *
+ * @param stage - The stage
+ * @param job - The submission
+ */
+void ValidationPipeline::enqueue ( Stage stage, std::unique_ptr<Job> job ) {
+	StageState &state = *( this -> stages[stage] );
+	job -> queued = std::chrono::steady_clock::now ();
+
+	if ( !( state.queue.push ( std::move ( job ) ) ) )
+		throw std::runtime_error ( "Attempted queueing work for a stopped validation pipeline!" );
+
+	size_t depth = state.queue.size ();
+	size_t deepest = state.max_depth.load ();
+	while ( depth > deepest && !( state.max_depth.compare_exchange_weak ( deepest, depth ) ) );
+}
+
+/**
+ * A stage worker's main loop
+ * (A rejected submission skips straight to the commit stage, which reports it)
+ *
+ * @param stage - The worker's stage
+ */
+void ValidationPipeline::run ( Stage stage ) {
+	StageState &state = *( this -> stages[stage] );
+
+	std::unique_ptr<Job> job;
+	while ( state.queue.pop ( job ) ) {
+		std::chrono::steady_clock::time_point started = std::chrono::steady_clock::now ();
+		state.wait_time += std::chrono::duration_cast<std::chrono::nanoseconds> ( started - job -> queued ).count ();
+
+		if ( stage == COMMIT ) {
+			this -> commit ( std::move ( job ) );
+		} else {
+			try {
+				this -> process ( stage, *job );
+			} catch ( const std::runtime_error &error ) {
+				job -> error = error.what ();
+			}
+		}
+
+		state.work_time += std::chrono::duration_cast<std::chrono::nanoseconds> ( std::chrono::steady_clock::now () - started ).count ();
+		state.processed++;
+
+		if ( stage == COMMIT )
+			continue;
+
+		Stage next = (Stage) ( stage + 1 );
+		if ( !( job -> error.empty () ) ) {
+			state.rejected++;
+			next = COMMIT;
+		}
+
+		this -> enqueue ( next, std::move ( job ) );
+	}
+}
+
+/**
+ * Runs one stage's checks on a submission
+ * (A block's transactions and signatures are checked across the chain's
+ * threads, so a single large block doesn't validate on one core)
+ *
+ * @param stage - The stage
+ * @param job - The submission
+ */
+void ValidationPipeline::process ( Stage stage, Job &job ) {
+	switch ( stage ) {
+
+		// Decodes the submission
+		case DECODE: {
+			serialize::Span bytes { reinterpret_cast<const unsigned char*> ( job.bytes.data () ), job.bytes.size () };
+			if ( job.is_block )
+				job.block = std::make_unique<Block> ( Block::decode ( bytes ) );
+			else
+				job.transaction = std::make_unique<Transaction> ( Transaction::decode ( bytes ) );
+
+			std::string ().swap ( job.bytes );
+			return;
+		}
+
+		// Checks the header, the links and the amounts, without hashing any transaction
+		case STRUCTURE:
+			if ( job.is_block ) {
+				if ( job.block -> difficulty != this -> chain.difficulty || !( job.block -> verify_header ( false, this -> chain.reward ) ) )
+					throw std::runtime_error ( "Rejected a block with an invalid header!" );
+			} else if ( !( job.transaction -> verify_structure () ) )
+				throw std::runtime_error ( "Rejected a malformed transaction!" );
+
+			return;
+
+		// Rehashes the transactions and checks everything but the signatures
+		case HASHES:
+			if ( job.is_block ) {
+				Block &block = *( job.block );
+				if ( !( block.verify_merkel_tree () ) || !( block.verify_coinbase ( this -> chain.reward ) ) )
+					throw std::runtime_error ( "Rejected a block with an invalid merkel tree or coinbase!" );
+
+				bool valid = parallel::all_of ( block.transactions.size () - 1, this -> chain.threads, [&block] ( size_t x ) {
+					Transaction &transaction = block.transactions[x + 1];
+					return transaction.verify ( false, false ) && transaction.tx_index == block.index + (long) ( x + 1 );
+				} );
+
+				if ( !valid )
+					throw std::runtime_error ( "Rejected a block with an invalid transaction!" );
+			} else if ( !( job.transaction -> verify ( false, false ) ) )
+				throw std::runtime_error ( "Rejected an invalid transaction!" );
+
+			return;
+
+		// Checks every signature
+		case SIGNATURES:
+			if ( job.is_block ? !( job.block -> verify_signatures ( this -> chain.threads ) ) : !( job.transaction -> verify_signatures () ) )
+				throw std::runtime_error ( "Rejected a submission with an invalid signature!" );
+
+			return;
+
+		default:
+			return;
+	}
+}
+
+/**
+ * Commits submissions in the order they were made, recording each outcome
+ * (Only ever called by the single commit worker)
+ *
+ * @param job - A submission which has passed every stage or been rejected
+ */
+void ValidationPipeline::commit ( std::unique_ptr<Job> job ) {
+	this -> reorder.emplace ( job -> sequence, std::move ( job ) );
+
+	while ( !( this -> reorder.empty () ) && this -> reorder.begin () -> first == this -> finished ) {
+		std::unique_ptr<Job> next = std::move ( this -> reorder.begin () -> second );
+		this -> reorder.erase ( this -> reorder.begin () );
+
+		if ( next -> error.empty () ) {
+			try {
+				if ( next -> is_block )
+					this -> chain.accept_block ( std::move ( *( next -> block ) ), true );
+				else if ( !( this -> chain.mempool.add ( std::move ( *( next -> transaction ) ), true ) ) )
+					next -> error = "Attempted adding a transaction with too low a priority for the mempool!";
+			} catch ( const std::runtime_error &error ) {
+				next -> error = error.what ();
+			}
+
+			if ( !( next -> error.empty () ) )
+				this -> stages[COMMIT] -> rejected++;
+		}
+
+		std::lock_guard<std::mutex> lock ( this -> mutex );
+		this -> results.push_back ( SubmitResult { next -> error.empty (), next -> error } );
+		this -> finished++;
+		this -> committed.notify_all ();
+	}
+}
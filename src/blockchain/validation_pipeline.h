@@ -0,0 +1,110 @@
+#pragma once
+#ifndef VALIDATION_PIPELINE_H
+#define VALIDATION_PIPELINE_H
+
+#include <map>
+#include <array>
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <condition_variable>
+#include "block.h"
+#include "mempool.h"
+#include "blockchain.h"
+#include "transaction.h"
+#include "algorithms/bounded_queue.h"
+#include "algorithms/parallel.h"
+#include "algorithms/serialize.h"
+
+/**
+ * Validates encoded blocks and transactions in stages, each with its own
+ * bounded queue and workers
+ * (Cheap checks run before any transaction is hashed, and hashing before any
+ * signature is checked, so a bogus submission is dropped early; meanwhile
+ * other submissions are at other stages. A full queue blocks the stage which
+ * feeds it, all the way back to the submitter. Submissions are committed to
+ * the chain or the mempool in the order they were made, by a single worker
+ * which owns the chain's updates while the pipeline runs)
+ */
+class ValidationPipeline {
+	public:
+		enum Stage { DECODE, STRUCTURE, HASHES, SIGNATURES, COMMIT, STAGES };
+
+		static const size_t DEFAULT_CAPACITY = 64;
+
+		struct StageConfig {
+			unsigned int workers;
+			size_t capacity;
+		};
+
+		struct StageStats {
+			std::string name;
+			size_t depth;
+			size_t max_depth;
+			uint64_t processed;
+			uint64_t rejected;
+			double wait_latency;
+			double work_latency;
+		};
+
+		ValidationPipeline ( Blockchain &chain );
+		ValidationPipeline ( Blockchain &chain, unsigned int threads );
+		ValidationPipeline ( Blockchain &chain, std::array<StageConfig, STAGES> config );
+		~ValidationPipeline ();
+
+		uint64_t submit_block ( std::string bytes );
+		uint64_t submit_transaction ( std::string bytes );
+		std::vector<SubmitResult> drain ();
+		void stop ();
+
+		std::vector<StageStats> stats ();
+		static std::string stage_name ( Stage stage );
+
+	private:
+		struct Job {
+			uint64_t sequence;
+			bool is_block;
+			std::string bytes;
+			std::unique_ptr<Block> block;
+			std::unique_ptr<Transaction> transaction;
+			std::string error;
+			std::chrono::steady_clock::time_point queued;
+		};
+
+		struct StageState {
+			BoundedQueue<std::unique_ptr<Job>> queue;
+			std::vector<std::thread> workers;
+			std::atomic<size_t> max_depth;
+			std::atomic<uint64_t> processed;
+			std::atomic<uint64_t> rejected;
+			std::atomic<uint64_t> wait_time;
+			std::atomic<uint64_t> work_time;
+
+			StageState ( size_t capacity );
+		};
+
+		Blockchain &chain;
+		std::array<std::unique_ptr<StageState>, STAGES> stages;
+		bool stopped;
+
+		std::mutex submitting;
+		std::mutex mutex;
+		std::condition_variable committed;
+		uint64_t submitted;
+		uint64_t finished;
+		std::vector<SubmitResult> results;
+		std::map<uint64_t, std::unique_ptr<Job>> reorder;
+
+		uint64_t submit ( std::string bytes, bool is_block );
+		void enqueue ( Stage stage, std::unique_ptr<Job> job );
+		void run ( Stage stage );
+		void process ( Stage stage, Job &job );
+		void commit ( std::unique_ptr<Job> job );
+};
+
+#endif
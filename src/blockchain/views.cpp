@@ -0,0 +1,362 @@
+#include "views.h"
+
+/**
+ * Skips over a number of length prefixed entries
+ *
+ * @param bytes - The encoding
+ * @param offset - The offset of the first entry
+ * @param count - The number of entries which should be skipped
+ * @returns A reader positioned at the entry after the skipped ones
+ */
+static serialize::Reader skip_entries ( serialize::Span bytes, size_t offset, size_t count ) {
+	serialize::Reader reader ( bytes );
+	reader.skip ( offset );
+
+	for ( size_t x = 0; x < count; x++ )
+		reader.skip ( reader.u32 () );
+
+	return reader;
+}
+
+/**
+ * Copies a hash out of an encoding
+ *
+ * @param data - The hash's first byte
+ * @returns The hash
+ */
+static Hash256 read_hash ( const unsigned char *data ) {
+	Hash256 hash;
+	std::memcpy ( hash.bytes, data, sizeof ( hash.bytes ) );
+	return hash;
+}
+
+/**
+ * The output view constructor
+ *
+ * @param bytes - An output written by TransactionOutput::encode
+ */
+TransactionOutputView::TransactionOutputView ( serialize::Span bytes ) {
+	serialize::Reader reader ( bytes );
+
+	this -> data = bytes;
+	this -> signature_field = reader.bytes ();
+	reader.skip ( 8 );
+	this -> payload_offset = reader.position ();
+	reader.skip ( 9 + 2 * SHA256_DIGEST_LENGTH );
+
+	if ( reader.remaining () != 0 )
+		throw std::runtime_error ( "Trailing bytes after serialized output!" );
+}
+
+serialize::Span TransactionOutputView::signature () const {
+	return this -> signature_field;
+}
+
+long TransactionOutputView::tx_index () const {
+	return (long) serialize::read_u64 ( this -> data.data + this -> payload_offset - 8 );
+}
+
+long TransactionOutputView::value () const {
+	return (long) serialize::read_u64 ( this -> data.data + this -> payload_offset );
+}
+
+bool TransactionOutputView::spent () const {
+	return this -> data.data[this -> payload_offset + 8] != 0;
+}
+
+Hash256 TransactionOutputView::author () const {
+	return read_hash ( this -> data.data + this -> payload_offset + 9 );
+}
+
+Hash256 TransactionOutputView::recipient () const {
+	return read_hash ( this -> data.data + this -> payload_offset + 9 + SHA256_DIGEST_LENGTH );
+}
+
+/**
+ * Gets the part of the output which is signed
+ *
+ * @returns The same bytes as TransactionOutput::to_bytes ( true )
+ */
+serialize::Span TransactionOutputView::payload () const {
+	return serialize::Span { this -> data.data + this -> payload_offset, this -> data.size - this -> payload_offset };
+}
+
+serialize::Span TransactionOutputView::bytes () const {
+	return this -> data;
+}
+
+TransactionOutput TransactionOutputView::to_output () const {
+	serialize::Reader reader ( this -> data );
+	return TransactionOutput::decode ( reader );
+}
+
+/**
+ * The input view constructor
+ *
+ * @param bytes - An input written by TransactionInput::encode
+ */
+TransactionInputView::TransactionInputView ( serialize::Span bytes ) {
+	if ( bytes.size < SHA256_DIGEST_LENGTH )
+		throw std::runtime_error ( "Truncated serialized data!" );
+
+	this -> data = bytes;
+}
+
+Hash256 TransactionInputView::hash () const {
+	return read_hash ( this -> data.data );
+}
+
+TransactionOutputView TransactionInputView::prev_out () const {
+	return TransactionOutputView ( serialize::Span { this -> data.data + SHA256_DIGEST_LENGTH, this -> data.size - SHA256_DIGEST_LENGTH } );
+}
+
+serialize::Span TransactionInputView::bytes () const {
+	return this -> data;
+}
+
+TransactionInput TransactionInputView::to_input () const {
+	serialize::Reader reader ( this -> data );
+	return TransactionInput::decode ( reader );
+}
+
+/**
+ * The transaction view constructor
+ * (Only walks the input and output lengths, nothing is copied)
+ *
+ * @param bytes - A transaction written by Transaction::encode
+ */
+TransactionView::TransactionView ( serialize::Span bytes ) {
+	serialize::Reader reader ( bytes );
+	reader.version ();
+	reader.skip ( 16 );
+
+	this -> data = bytes;
+	this -> inputs = reader.u32 ();
+	this -> inputs_offset = reader.position ();
+	for ( size_t x = 0; x < this -> inputs; x++ )
+		reader.skip ( reader.u32 () );
+
+	this -> outputs = reader.u32 ();
+	this -> outputs_offset = reader.position ();
+	for ( size_t x = 0; x < this -> outputs; x++ )
+		reader.skip ( reader.u32 () );
+
+	if ( reader.remaining () != 0 )
+		throw std::runtime_error ( "Trailing bytes after serialized transaction!" );
+}
+
+long TransactionView::tx_index () const {
+	return (long) serialize::read_u64 ( this -> data.data + 1 );
+}
+
+std::chrono::milliseconds TransactionView::time () const {
+	return std::chrono::milliseconds ( (long long) serialize::read_u64 ( this -> data.data + 9 ) );
+}
+
+size_t TransactionView::input_count () const {
+	return this -> inputs;
+}
+
+/**
+ * Gets one of the transaction's inputs
+ *
+ * @param position - The input's position in the transaction
+ * @returns A view of the input
+ */
+TransactionInputView TransactionView::input ( size_t position ) const {
+	if ( position >= this -> inputs )
+		throw std::runtime_error ( "Attempted reading an input outside the transaction!" );
+
+	serialize::Reader reader = skip_entries ( this -> data, this -> inputs_offset, position );
+	return TransactionInputView ( reader.bytes () );
+}
+
+size_t TransactionView::output_count () const {
+	return this -> outputs;
+}
+
+/**
+ * Gets one of the transaction's outputs
+ *
+ * @param position - The output's position in the transaction
+ * @returns A view of the output
+ */
+TransactionOutputView TransactionView::output ( size_t position ) const {
+	if ( position >= this -> outputs )
+		throw std::runtime_error ( "Attempted reading an output outside the transaction!" );
+
+	serialize::Reader reader = skip_entries ( this -> data, this -> outputs_offset, position );
+	return TransactionOutputView ( reader.bytes () );
+}
+
+/**
+ * Hashes the encoded transaction
+ *
+ * @returns The transaction's hash
+ */
+Hash256 TransactionView::hash () const {
+	return crypto::sha256 ( this -> data.data, this -> data.size );
+}
+
+serialize::Span TransactionView::bytes () const {
+	return this -> data;
+}
+
+Transaction TransactionView::to_transaction () const {
+	return Transaction::decode ( this -> data );
+}
+
+/**
+ * The block view constructor
+ *
+ * @param bytes - A block written by Block::encode
+ */
+BlockView::BlockView ( serialize::Span bytes ) {
+	serialize::Reader reader ( bytes );
+	reader.version ();
+	reader.skip ( TRANSACTIONS_OFFSET - HASH_OFFSET );
+
+	this -> data = bytes;
+	this -> transactions = reader.u32 ();
+	for ( size_t x = 0; x < this -> transactions; x++ )
+		reader.skip ( reader.u32 () );
+
+	this -> keys = reader.u32 ();
+	this -> keys_offset = reader.position ();
+	for ( size_t x = 0; x < this -> keys; x++ )
+		reader.skip ( reader.u32 () );
+
+	if ( reader.remaining () != 0 )
+		throw std::runtime_error ( "Trailing bytes after serialized block!" );
+}
+
+Hash256 BlockView::hash () const {
+	return read_hash ( this -> data.data + HASH_OFFSET );
+}
+
+Hash256 BlockView::prev_block () const {
+	return read_hash ( this -> data.data + HEADER_OFFSET );
+}
+
+Hash256 BlockView::merkel_tree () const {
+	return read_hash ( this -> data.data + HEADER_OFFSET + SHA256_DIGEST_LENGTH );
+}
+
+std::chrono::milliseconds BlockView::time () const {
+	return std::chrono::milliseconds ( (long long) serialize::read_u64 ( this -> data.data + HEADER_OFFSET + 2 * SHA256_DIGEST_LENGTH ) );
+}
+
+long BlockView::index () const {
+	return (long) serialize::read_u64 ( this -> data.data + HEADER_OFFSET + 2 * SHA256_DIGEST_LENGTH + 8 );
+}
+
+long long BlockView::nonce () const {
+	return (long long) serialize::read_u64 ( this -> data.data + HEADER_OFFSET + Block::HEADER_PREFIX_SIZE );
+}
+
+int BlockView::difficulty () const {
+	return (int) serialize::read_u32 ( this -> data.data + HEADER_OFFSET + Block::HEADER_SIZE );
+}
+
+size_t BlockView::transaction_count () const {
+	return this -> transactions;
+}
+
+/**
+ * Gets one of the block's transactions
+ *
+ * @param position - The transaction's position in the block
+ * @returns A view of the transaction
+ */
+TransactionView BlockView::transaction ( size_t position ) const {
+	if ( position >= this -> transactions )
+		throw std::runtime_error ( "Attempted reading a transaction outside the block!" );
+
+	serialize::Reader reader = skip_entries ( this -> data, TRANSACTIONS_OFFSET + 4, position );
+	return TransactionView ( reader.bytes () );
+}
+
+/**
+ * Gets an iterator at the block's first transaction
+ * (Prefer iterating to calling transaction () for every position, which
+ * walks the block from the start each time)
+ *
+ * @returns The iterator
+ */
+TransactionIterator BlockView::begin () const {
+	return TransactionIterator ( this -> data, TRANSACTIONS_OFFSET + 4, 0 );
+}
+
+TransactionIterator BlockView::end () const {
+	return TransactionIterator ( this -> data, this -> keys_offset - 4, this -> transactions );
+}
+
+size_t BlockView::key_count () const {
+	return this -> keys;
+}
+
+/**
+ * Gets one of the public keys shipped with the block
+ *
+ * @param position - The key's position in the block
+ * @returns The key's PEM
+ */
+serialize::Span BlockView::key ( size_t position ) const {
+	if ( position >= this -> keys )
+		throw std::runtime_error ( "Attempted reading a key outside the block!" );
+
+	serialize::Reader reader = skip_entries ( this -> data, this -> keys_offset, position );
+	return reader.bytes ();
+}
+
+/**
+ * Gets the block's binary header, which is what the block's hash commits to
+ *
+ * @returns The same bytes as Block::to_header
+ */
+serialize::Span BlockView::header () const {
+	return serialize::Span { this -> data.data + HEADER_OFFSET, Block::HEADER_SIZE };
+}
+
+serialize::Span BlockView::bytes () const {
+	return this -> data;
+}
+
+Block BlockView::to_block () const {
+	return Block::decode ( this -> data );
+}
+
+/**
+ * The transaction iterator constructor
+ *
+ * @param block - The block's encoding, already checked by BlockView
+ * @param offset - Where the transaction's length prefix starts
+ * @param position - The transaction's position in the block
+ */
+TransactionIterator::TransactionIterator ( serialize::Span block, size_t offset, size_t position ) {
+	this -> block = block;
+	this -> offset = offset;
+	this -> index = position;
+}
+
+TransactionView TransactionIterator::operator* () const {
+	return TransactionView ( serialize::Span { this -> block.data + this -> offset + 4, serialize::read_u32 ( this -> block.data + this -> offset ) } );
+}
+
+TransactionIterator &TransactionIterator::operator++ () {
+	this -> offset += 4 + serialize::read_u32 ( this -> block.data + this -> offset );
+	this -> index++;
+	return *this;
+}
+
+bool TransactionIterator::operator== ( const TransactionIterator &other ) const {
+	return this -> block.data == other.block.data && this -> index == other.index;
+}
+
+bool TransactionIterator::operator!= ( const TransactionIterator &other ) const {
+	return !( *this == other );
+}
+
+size_t TransactionIterator::position () const {
+	return this -> index;
+}
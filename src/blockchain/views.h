@@ -0,0 +1,139 @@
+#pragma once
+#ifndef VIEWS_H
+#define VIEWS_H
+
+#include <chrono>
+#include <cstddef>
+#include <iterator>
+#include "block.h"
+#include "transaction.h"
+#include "transaction_input.h"
+#include "transaction_output.h"
+#include "algorithms/crypto.h"
+#include "algorithms/serialize.h"
+
+/**
+ * Read-only accessors over encoded outputs, inputs, transactions and blocks
+ * (Fields are read straight from the bytes, which must outlive the view)
+ */
+
+class TransactionOutputView {
+	public:
+		TransactionOutputView ( serialize::Span bytes );
+
+		serialize::Span signature () const;
+		long tx_index () const;
+		long value () const;
+		bool spent () const;
+		Hash256 author () const;
+		Hash256 recipient () const;
+
+		serialize::Span payload () const;
+		serialize::Span bytes () const;
+		TransactionOutput to_output () const;
+
+	private:
+		serialize::Span data;
+		serialize::Span signature_field;
+		size_t payload_offset;
+};
+
+class TransactionInputView {
+	public:
+		TransactionInputView ( serialize::Span bytes );
+
+		Hash256 hash () const;
+		TransactionOutputView prev_out () const;
+
+		serialize::Span bytes () const;
+		TransactionInput to_input () const;
+
+	private:
+		serialize::Span data;
+};
+
+class TransactionView {
+	public:
+		TransactionView ( serialize::Span bytes );
+
+		long tx_index () const;
+		std::chrono::milliseconds time () const;
+		size_t input_count () const;
+		TransactionInputView input ( size_t position ) const;
+		size_t output_count () const;
+		TransactionOutputView output ( size_t position ) const;
+
+		Hash256 hash () const;
+		serialize::Span bytes () const;
+		Transaction to_transaction () const;
+
+	private:
+		serialize::Span data;
+		size_t inputs_offset;
+		size_t outputs_offset;
+		size_t inputs;
+		size_t outputs;
+};
+
+/**
+ * Walks a block's transactions in order
+ * (Each step reads one length prefix, so visiting every transaction is a
+ * single pass over the block instead of one pass per transaction)
+ */
+class TransactionIterator {
+	public:
+		typedef std::forward_iterator_tag iterator_category;
+		typedef TransactionView value_type;
+		typedef std::ptrdiff_t difference_type;
+		typedef const TransactionView *pointer;
+		typedef TransactionView reference;
+
+		TransactionIterator ( serialize::Span block, size_t offset, size_t position );
+
+		TransactionView operator* () const;
+		TransactionIterator &operator++ ();
+		bool operator== ( const TransactionIterator &other ) const;
+		bool operator!= ( const TransactionIterator &other ) const;
+
+		size_t position () const;
+
+	private:
+		serialize::Span block;
+		size_t offset;
+		size_t index;
+};
+
+class BlockView {
+	public:
+		static const size_t HASH_OFFSET = 1;
+		static const size_t HEADER_OFFSET = HASH_OFFSET + SHA256_DIGEST_LENGTH;
+		static const size_t TRANSACTIONS_OFFSET = HEADER_OFFSET + Block::HEADER_SIZE + 4;
+
+		BlockView ( serialize::Span bytes );
+
+		Hash256 hash () const;
+		Hash256 prev_block () const;
+		Hash256 merkel_tree () const;
+		std::chrono::milliseconds time () const;
+		long index () const;
+		long long nonce () const;
+		int difficulty () const;
+		size_t transaction_count () const;
+		TransactionView transaction ( size_t position ) const;
+		TransactionIterator begin () const;
+		TransactionIterator end () const;
+		size_t key_count () const;
+		serialize::Span key ( size_t position ) const;
+
+		serialize::Span header () const;
+		serialize::Span bytes () const;
+		Block to_block () const;
+
+	private:
+		serialize::Span data;
+		size_t transactions;
+		size_t keys_offset;
+		size_t keys;
+};
+
+#endif
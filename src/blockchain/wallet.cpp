@@ -1,10 +1,21 @@
 #include "wallet.h"
 
-Wallet::Wallet ( int key_size = 4096 ) {
+Wallet::Wallet ( int key_size = 4096 ) : Wallet ( crypto::SignatureScheme::rsa ( key_size ) ) {}
 
-	// Generates wallet RSA keypair
-	this -> keypair = generate_keypair ( key_size );
+/**
+ * Creates a wallet whose keypair uses a given signature scheme
+ *
+ * @param scheme - The scheme used to generate the keypair and sign outputs
+ */
+Wallet::Wallet ( std::shared_ptr<crypto::SignatureScheme> scheme ) {
+
+	// Generates wallet keypair
+	this -> scheme = scheme;
+	this -> keypair = scheme -> generate_keypair ();
 	this -> public_key = public_key_to_string ( keypair );
+	this -> key = KeyTable::global ().intern ( this -> public_key );
+	this -> synced = 0;
+	this -> synced_height = 0;
 }
 
 Wallet::~Wallet () {
@@ -13,33 +24,6 @@ Wallet::~Wallet () {
 	EVP_PKEY_free ( keypair );
 }
 
-/**
- * Generates a new RSA keypair
- *
- * @param key_size - An int describing the length of the key (recommended 4096 bits)
- */ 
-EVP_PKEY *Wallet::generate_keypair ( int key_size ) {
-	
-	RSA *rsa = RSA_new ();
-	BIGNUM *e = BN_new ();
-	EVP_PKEY *keypair = EVP_PKEY_new ();
-
-	// Sets the public exponent
-	if ( BN_set_word ( e, RSA_F4 ) != 1 )
-		throw std::runtime_error ( "Failed to set the RSA public exponent!" );
-
-	// Generates new RSA keypair
-	if ( RSA_generate_key_ex ( rsa, key_size, e, NULL ) != 1 )
-		throw std::runtime_error ( "Failed to generate the RSA keypair!" );
-
-	// Assigns the RSA keypair to an EVP_PKEY keypair
-	if ( EVP_PKEY_assign_RSA ( keypair, rsa ) != 1 )
-		throw std::runtime_error ( "Failed to assign the RSA keypair!" );
-
-	return keypair;
-
-}
-
 /**
  * Converts a given EVP_PKEY to a string with the public key
  *
@@ -47,7 +31,7 @@ EVP_PKEY *Wallet::generate_keypair ( int key_size ) {
  */
 std::string Wallet::public_key_to_string ( EVP_PKEY *key ) {
 
-	// Writes the RSA public key to memory
+	// Writes the public key to memory
 	BIO *bio = BIO_new ( BIO_s_mem () );
 	if ( PEM_write_bio_PUBKEY ( bio, key ) != 1 ) {
 		BIO_free ( bio );
@@ -60,13 +44,64 @@ std::string Wallet::public_key_to_string ( EVP_PKEY *key ) {
 	return buffer;
 }
 
+/**
+ * Updates the wallet's unspent outputs from the chain
+ * (Picks up newly mined outputs to the wallet and drops the ones which have
+ * been spent; an output used by a pending transaction stays reserved until
+ * its spend is mined. If the last synced block has since been disconnected
+ * the whole history is rescanned, as the reorganization may have replaced
+ * outputs the wallet already counted, or returned ones it saw spent)
+ *
+ * @param chain - The blockchain
+ */
+void Wallet::sync ( Blockchain &chain ) {
+
+	// Starts over if the last synced block is no longer part of the chain
+	if ( this -> synced_height != 0 && ( this -> synced_height > chain.height () || chain.blocks.header ( this -> synced_height - 1 ).hash != this -> synced_tip ) ) {
+		this -> unspent.clear ();
+		this -> synced = 0;
+	}
+
+	// Adds the outputs mined since the last sync
+	Hash256 address = KeyTable::global ().id ( this -> key );
+	std::vector<OutputRef> history = chain.get_history ( this -> public_key, this -> synced, SIZE_MAX );
+	for ( auto &ref : history ) {
+		TransactionOutputView output = chain.blocks.view ( ref.height ).transaction ( ref.position ).output ( ref.output );
+		if ( output.recipient () == address )
+			this -> unspent.push_back ( output.to_output () );
+	}
+
+	this -> synced += history.size ();
+	this -> synced_height = chain.height ();
+	this -> synced_tip = chain.blocks.header ( chain.height () - 1 ).hash;
+
+	// Drops the outputs which have been spent, and the reservations of outputs which are gone
+	std::vector<TransactionOutput> unspent;
+	std::unordered_set<Hash256> reserved;
+	for ( auto &output : this -> unspent )
+		if ( chain.utxos.contains ( output.outpoint () ) ) {
+			if ( this -> reserved.count ( output.outpoint () ) != 0 )
+				reserved.insert ( output.outpoint () );
+
+			unspent.push_back ( output );
+		}
+
+	this -> unspent.swap ( unspent );
+	this -> reserved.swap ( reserved );
+}
+
+/**
+ * Gets the wallet's spendable balance
+ * (Confirmed unspent outputs which aren't reserved by a pending transaction)
+ *
+ * @returns The balance
+ */
 long Wallet::calculate_balance () {
 
 	long balance = 0;
-	for ( auto transaction : this -> incoming_transactions )
-		for ( auto output : transaction.outputs )
-			if ( output.recipient == this -> public_key )
-				balance += output.value;
+	for ( auto &output : this -> unspent )
+		if ( this -> reserved.count ( output.outpoint () ) == 0 )
+			balance += output.value;
 
 	return balance;
 }
@@ -74,49 +109,39 @@ long Wallet::calculate_balance () {
 Transaction Wallet::create_coinbase ( std::string recipient, long amount ) {
 
 	// Creates a new coinbase input
-	TransactionOutput output ( false, "", this -> public_key, amount, 0 );
-	TransactionInput input ( output );
-	std::vector<TransactionInput> inputs { input };
+	TransactionOutput output ( false, KeyTable::NONE, this -> key, amount, 0 );
+	std::vector<TransactionInput> inputs;
+	inputs.emplace_back ( std::move ( output ) );
 
 	// Creates a new coinbase transaction
-	Transaction transaction ( inputs, this -> public_key, recipient, amount );
+	Transaction transaction ( std::move ( inputs ), this -> key, KeyTable::global ().intern ( recipient ), amount );
 	this -> sign_transaction ( &transaction );
 	transaction.calculate_hash ();
 
-	// Adds transaction to wallet
-	this -> incoming_transactions.push_back ( transaction );
-
 	return transaction;
 }
 
+/**
+ * Picks unspent outputs covering an amount and reserves them
+ *
+ * @param amount - The amount which should be covered
+ * @returns The inputs spending the picked outputs
+ */
 std::vector<TransactionInput> Wallet::get_tx_inputs ( long amount ) {
 
 	std::vector<TransactionInput> inputs;
 	long total = 0;
-	for ( auto transaction : this -> incoming_transactions ) {
-
-		// Gets the total output value
-		long local_total = 0;
-		std::vector<std::vector<TransactionOutput>::iterator> outputs;
-		for ( std::vector<TransactionOutput>::iterator output = transaction.outputs.begin (); output != transaction.outputs.end (); output++ ) {
-			if ( output -> recipient == this -> public_key ) {
-				
-				// Adds the input
-				inputs.push_back ( TransactionInput ( *output ) );
-				local_total += output -> value;
-			
-				// Deletes the output from the transaction to prevent accidental double spending
-				outputs.push_back ( output );
-			}
-		}
-
-		for ( auto output : outputs ) 
-			transaction.outputs.erase ( output );
-
-		total += local_total;
-
+	for ( auto &output : this -> unspent ) {
 		if ( total >= amount )
 			break;
+
+		// Reserves the output to prevent accidental double spending
+		TransactionInput input ( output );
+		if ( !( this -> reserved.insert ( input.hash ).second ) )
+			continue;
+
+		inputs.push_back ( std::move ( input ) );
+		total += output.value;
 	}
 
 	return inputs;
@@ -192,7 +217,7 @@ Transaction Wallet::create_transaction ( std::string recipient, long amount ) {
 	auto inputs = this -> get_tx_inputs ( amount ); 
 
 	// Creates a new transaction
-	Transaction transaction ( inputs, this -> public_key, recipient, amount );
+	Transaction transaction ( std::move ( inputs ), this -> key, KeyTable::global ().intern ( recipient ), amount );
 	this -> sign_transaction ( &transaction );
 	transaction.calculate_hash ();
 
@@ -202,36 +227,15 @@ Transaction Wallet::create_transaction ( std::string recipient, long amount ) {
 void Wallet::sign_transaction ( Transaction *transaction ) {
 
 	// Loops over each output in the transaction
-	for ( std::vector<TransactionOutput>::iterator output = transaction -> outputs.begin (); output != transaction -> outputs.end (); output++ ) {
+	for ( std::pmr::vector<TransactionOutput>::iterator output = transaction -> outputs.begin (); output != transaction -> outputs.end (); output++ ) {
 
 
 		// Checks that the public key matches the output author
-		if ( output -> author != this -> public_key )
+		if ( output -> author != this -> key )
 			throw std::runtime_error ( "Attemped signing output with different author!" );
 
-		/* Signs the output */
-
-		// Creates the signing context
-		EVP_MD_CTX *context = EVP_MD_CTX_create ();
-		if ( EVP_DigestSignInit ( context, NULL, EVP_sha256 (), NULL, this -> keypair ) != 1 ) 
-			throw std::runtime_error ( "Failed to sign transaction output!" );
-
-		if ( EVP_DigestSignUpdate ( context, (const unsigned char*) output -> to_string ( true ).c_str (), output -> to_string ( true ).length () ) != 1 )
-			throw std::runtime_error ( "Failed to sign transaction output!" );
-
-		// Gets the hash size
-		size_t x = 8;
-		size_t *signature_length = &x;
-		if ( EVP_DigestSignFinal ( context, NULL, signature_length ) != 1 ) 
-			throw std::runtime_error ( "Failed to sign transaction output!" );
-
-		// Allocates memory for the signature hash
-		unsigned char *raw_signature = (unsigned char*) malloc ( *signature_length );
-		if ( EVP_DigestSignFinal ( context, raw_signature, signature_length ) != 1 ) 
-			throw std::runtime_error ( "Failed to sign transaction output!" );
-
-		std::string signature ( reinterpret_cast<char*> ( raw_signature ), *signature_length );
-		output -> signature = crypto::to_hex ( signature );
+		// Signs the output
+		output -> signature = this -> scheme -> sign ( this -> keypair, output -> to_bytes ( true ) );
 	}
 
 	// Updates 
@@ -4,6 +4,7 @@
 
 #include <iostream>
 #include <vector>
+#include <unordered_set>
 #include <stdlib.h>
 #include <openssl/rsa.h>
 #include <openssl/bn.h>
@@ -14,11 +15,15 @@
 #include "transaction_input.h"
 #include "transaction_output.h"
 #include "transaction.h"
+#include "blockchain.h"
+#include "key_table.h"
 #include "algorithms/crypto.h"
+#include "algorithms/signature.h"
 
 class Wallet {
 	public:
 		Wallet ( int key_size );
+		Wallet ( std::shared_ptr<crypto::SignatureScheme> scheme );
 		~Wallet ();
 
 		std::string public_key; 
@@ -27,14 +32,20 @@ class Wallet {
 		Transaction create_transaction ( std::string recipient, long amount );
 		void sign_transaction ( Transaction *transaction );
 
+		void sync ( Blockchain &chain );
 		long calculate_balance ();
 		std::vector<TransactionInput> get_tx_inputs ( long amount );
 
 	private:
+		std::shared_ptr<crypto::SignatureScheme> scheme;
 		EVP_PKEY *keypair;
-		std::vector<Transaction> incoming_transactions;
+		KeyTable::Handle key;
+		std::vector<TransactionOutput> unspent;
+		std::unordered_set<Hash256> reserved;
+		size_t synced;
+		size_t synced_height;
+		Hash256 synced_tip;
 
-		EVP_PKEY *generate_keypair ( int key_size );
 		std::string public_key_to_string ( EVP_PKEY *key );
 };
 